@@ -0,0 +1,62 @@
+#include "header.h"
+
+/**
+ * Records a new CPU time sample for a process and computes its usage
+ * Usage is the CPU time consumed since the previous sample divided by the
+ * system-wide CPU time that passed in between, so no sleeping is needed per PID.
+ * Like top, 100% means one full core.
+ *
+ * @param pid Process ID the sample belongs to
+ * @param current Freshly read utime/stime and the snapshot ticks they were read at
+ * @param snapshot System values of the current scan
+ * @return CPU usage percentage, or 0.0 when there is no previous sample yet
+ */
+float CPUUsageCalculator::update(int pid, const ProcessStats& current, const SystemSnapshot& snapshot) {
+    ProcessStats previous;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto [it, inserted] = previousSamples.try_emplace(pid, current);
+        if (inserted) {
+            return 0.0f; // First sighting - usage is known after the next scan
+        }
+        previous = it->second;
+        it->second = current;
+    }
+
+    if (previous.startTime != current.startTime) {
+        return 0.0f; // The PID now belongs to a different process - start its history afresh
+    }
+
+    unsigned long long previousTicks = previous.utime + previous.stime;
+    unsigned long long currentTicks = current.utime + current.stime;
+    if (currentTicks < previousTicks) {
+        return 0.0f; // Counters went backwards, should not happen for the same process
+    }
+    float processTicks = static_cast<float>(currentTicks - previousTicks);
+
+    // Preferred: compare against the system-wide ticks of both snapshots
+    if (previous.systemTicks > 0 && current.systemTicks > previous.systemTicks) {
+        float systemTicks = static_cast<float>(current.systemTicks - previous.systemTicks);
+        return 100.0f * processTicks * snapshot.numCores / systemTicks;
+    }
+
+    // Fallback when /proc/stat could not be read: compare against wall time
+    float elapsedSeconds = std::chrono::duration<float>(current.sampleTime - previous.sampleTime).count();
+    if (elapsedSeconds <= 0.0f || snapshot.clockTicksPerSecond <= 0) {
+        return 0.0f;
+    }
+    return 100.0f * processTicks / snapshot.clockTicksPerSecond / elapsedSeconds;
+}
+
+/**
+ * Drops the stored sample for a process that has exited
+ *
+ * @param pid Process ID to forget
+ */
+void CPUUsageCalculator::forget(int pid) {
+    std::lock_guard<std::mutex> lock(mutex);
+    previousSamples.erase(pid);
+}
+
+// Define the global accountant shared by all collector workers
+CPUUsageCalculator g_cpuUsageCalculator;
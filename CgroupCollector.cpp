@@ -0,0 +1,398 @@
+#include "header.h"
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+
+// Layout of the records returned by getdents64(2)
+struct CgroupDirent64 {
+    ino64_t d_ino;
+    off64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+};
+
+// Size of the reusable buffer for directory listings and file contents
+static constexpr size_t kCgroupBufferSize = 64 * 1024;
+
+// Passes after which files a cgroup lacked are looked for again (controllers
+// can be enabled for a subtree at any time)
+static constexpr unsigned CGROUP_PROBE_INTERVAL_PASSES = 15;
+
+// Most descriptors the collector keeps open between passes
+static constexpr size_t CGROUP_MAX_CACHED_FDS = 1024;
+
+static const char* const kCgroupFileNames[] = {"cpu.stat", "memory.current", "io.stat", "cpu.pressure"};
+
+/**
+ * Finds where the cgroup2 hierarchy is mounted
+ * That is /sys/fs/cgroup on unified hosts and /sys/fs/cgroup/unified on hybrid ones.
+ *
+ * @return Mount point, or an empty string if cgroup2 is not mounted
+ */
+static std::string FindCgroup2Mount() {
+    std::ifstream mounts("/proc/self/mounts");
+    std::string device, mountPoint, type, rest;
+    while (mounts >> device >> mountPoint >> type && std::getline(mounts, rest)) {
+        if (type == "cgroup2") {
+            return mountPoint;
+        }
+    }
+    return "";
+}
+
+/**
+ * Opens the cgroup2 mount and sizes the descriptor budget
+ * available() is false when no cgroup2 hierarchy is mounted.
+ */
+CgroupCollector::CgroupCollector() : buffer(kCgroupBufferSize) {
+    mountPoint = FindCgroup2Mount();
+    if (mountPoint.empty()) {
+        return;
+    }
+    rootFd = open(mountPoint.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (rootFd < 0) {
+        mountPoint.clear();
+        return;
+    }
+
+    // Leave most descriptors to the /proc cache and the rest of the process
+    fdBudget = CGROUP_MAX_CACHED_FDS;
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY) {
+        fdBudget = std::min<size_t>(fdBudget, limit.rlim_cur / 8);
+    }
+
+    root = std::make_unique<Node>();
+    root->dirFd = rootFd;
+}
+
+CgroupCollector::~CgroupCollector() {
+    if (root) {
+        release(*root);
+    }
+    if (rootFd >= 0) {
+        close(rootFd);
+    }
+}
+
+/**
+ * Closes the descriptors of a cgroup and of everything below it
+ *
+ * @param node Cgroup that went away, or the root on shutdown
+ */
+void CgroupCollector::release(Node& node) {
+    for (auto& [name, child] : node.children) {
+        release(*child);
+    }
+    node.children.clear();
+    for (int& fd : node.fds) {
+        if (fd >= 0) {
+            close(fd);
+            openFds--;
+        }
+        fd = -1;
+    }
+    if (node.dirFd >= 0 && node.dirFd != rootFd) {
+        close(node.dirFd);
+        openFds--;
+    }
+    node.dirFd = -1;
+}
+
+/**
+ * Opens a file of a cgroup, through the cgroup's directory descriptor if it
+ * has one and by path from the mount otherwise
+ *
+ * @param node Cgroup the file belongs to
+ * @param path Path of the cgroup relative to the mount
+ * @param name File name within the cgroup
+ * @param flags open(2) flags
+ * @return Descriptor, or -1 with errno set
+ */
+int CgroupCollector::openAt(Node& node, const std::string& path, const char* name, int flags) {
+    syscalls++;
+    if (node.dirFd >= 0) {
+        return openat(node.dirFd, name, flags | O_CLOEXEC);
+    }
+    std::string relative = path + "/" + name;
+    return openat(rootFd, relative.c_str(), flags | O_CLOEXEC);
+}
+
+/**
+ * Reads one file of a cgroup into the shared buffer, NUL-terminated
+ * Descriptors are kept open while the budget allows, so later passes only pread.
+ * A cached descriptor whose read fails (the cgroup was removed, so kernfs
+ * answers ENODEV) is closed and the file is reopened once.
+ *
+ * @param node Cgroup to read from
+ * @param path Path of the cgroup relative to the mount
+ * @param file File to read
+ * @return Bytes read, or -1 if the file is absent or unreadable
+ */
+ssize_t CgroupCollector::readFile(Node& node, const std::string& path, CgroupFile file) {
+    int& cached = node.fds[file];
+    if (cached == -2) {
+        return -1;
+    }
+
+    for (int attempt = 0; attempt < 2; attempt++) {
+        int fd = cached;
+        if (fd < 0) {
+            fd = openAt(node, path, kCgroupFileNames[file], O_RDONLY);
+            if (fd < 0) {
+                if (errno == ENOENT) {
+                    cached = -2;
+                }
+                return -1;
+            }
+        }
+
+        ssize_t bytes = pread(fd, buffer.data(), buffer.size() - 1, 0);
+        syscalls++;
+        if (cached >= 0 && bytes < 0) {
+            // Stale descriptor: drop it and try a fresh one
+            close(cached);
+            syscalls++;
+            openFds--;
+            cached = -1;
+            continue;
+        }
+        if (cached < 0) {
+            if (openFds < fdBudget && bytes >= 0) {
+                cached = fd;
+                openFds++;
+            } else {
+                close(fd);
+                syscalls++;
+            }
+        }
+        if (bytes < 0) {
+            return -1;
+        }
+        buffer[bytes] = '\0';
+        return bytes;
+    }
+    return -1;
+}
+
+/**
+ * Re-lists the subdirectories of a cgroup and updates its children to match
+ * Cgroups that appeared get a node (and a directory descriptor if the budget
+ * allows); cgroups that went away are released. Children are matched by name
+ * and inode, so a cgroup removed and recreated under the same name between
+ * two passes (a service restart) gets a new node instead of keeping
+ * descriptors to the dead one.
+ *
+ * @param node Cgroup to list
+ * @param path Path of the cgroup relative to the mount
+ * @return false if the directory could not be read (it is likely being removed)
+ */
+bool CgroupCollector::listChildren(Node& node, const std::string& path) {
+    int fd = node.dirFd;
+    if (fd >= 0) {
+        if (lseek(fd, 0, SEEK_SET) < 0) {
+            return false;
+        }
+        syscalls++;
+    } else {
+        fd = openat(rootFd, path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        syscalls++;
+        if (fd < 0) {
+            return false;
+        }
+    }
+
+    names.clear();
+    bool ok = true;
+    while (true) {
+        long bytes = syscall(SYS_getdents64, fd, buffer.data(), buffer.size());
+        syscalls++;
+        if (bytes < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytes <= 0) {
+            ok = bytes == 0;
+            break;
+        }
+        for (long offset = 0; offset < bytes;) {
+            auto* entry = reinterpret_cast<CgroupDirent64*>(buffer.data() + offset);
+            offset += entry->d_reclen;
+            if (entry->d_type == DT_DIR && strcmp(entry->d_name, ".") != 0 && strcmp(entry->d_name, "..") != 0) {
+                names.emplace_back(entry->d_name, entry->d_ino);
+            }
+        }
+    }
+    if (fd != node.dirFd) {
+        close(fd);
+        syscalls++;
+    }
+    if (!ok) {
+        return false;
+    }
+
+    // Merge the sorted listing with the children map, which is ordered by name too
+    std::sort(names.begin(), names.end());
+    auto child = node.children.begin();
+    for (const auto& [name, inode] : names) {
+        while (child != node.children.end() && child->first < name) {
+            release(*child->second);
+            child = node.children.erase(child);
+        }
+        if (child != node.children.end() && child->first == name) {
+            if (child->second->inode == inode) {
+                ++child;
+                continue;
+            }
+            // Recreated under the same name: its descriptors and counters belong to the old cgroup
+            release(*child->second);
+            child = node.children.erase(child);
+        }
+        auto added = std::make_unique<Node>();
+        added->inode = inode;
+        if (openFds < fdBudget) {
+            added->dirFd = openAt(node, path, name.c_str(), O_RDONLY | O_DIRECTORY);
+            if (added->dirFd >= 0) {
+                openFds++;
+            }
+        }
+        node.children.emplace_hint(child, name, std::move(added));
+    }
+    while (child != node.children.end()) {
+        release(*child->second);
+        child = node.children.erase(child);
+    }
+    return true;
+}
+
+/**
+ * Reads one cgroup, appends it to the pre-order and recurses into its children
+ *
+ * @param node Cgroup to read
+ * @param path Path relative to the mount ("." for the root)
+ * @param name Name shown for the cgroup
+ * @param parent Index of the parent in out, -1 for the root
+ * @param depth Depth below the root
+ * @param out Nodes of the pass in pre-order
+ * @param now Time the pass started, used for every rate of the pass
+ */
+void CgroupCollector::walk(Node& node, const std::string& path, const std::string& name, int32_t parent,
+                           uint32_t depth, std::vector<CgroupInfo>& out,
+                           std::chrono::steady_clock::time_point now) {
+    if (++node.passesSinceProbe >= CGROUP_PROBE_INTERVAL_PASSES) {
+        node.passesSinceProbe = 0;
+        for (int& fd : node.fds) {
+            if (fd == -2) {
+                fd = -1;
+            }
+        }
+    }
+
+    CgroupInfo info{path == "." ? "/" : "/" + path, name, parent, depth, 1, -1.0f, -1, -1.0f, -1.0f, -1.0, -1.0,
+                    -1.0f, -1.0f};
+    Counters current;
+    current.takenAt = now;
+    current.valid = true;
+    const Counters& previous = node.previous;
+    double seconds = std::chrono::duration<double>(now - previous.takenAt).count();
+    bool haveRate = previous.valid && seconds > 0.0;
+    auto rate = [seconds](unsigned long long value, unsigned long long before) {
+        return value > before ? static_cast<double>(value - before) / seconds : 0.0;
+    };
+
+    // cpu.stat: "key value" lines; the nr_* and throttled_* keys need the cpu controller
+    if (readFile(node, path, CpuStat) >= 0) {
+        bool throttling = false;
+        for (const char* line = buffer.data(); *line;) {
+            const char* space = strchr(line, ' ');
+            const char* end = strchr(line, '\n');
+            if (!space || (end && space > end)) {
+                break;
+            }
+            std::string_view key(line, space - line);
+            unsigned long long value = strtoull(space + 1, nullptr, 10);
+            if (key == "usage_usec") {
+                current.usageUsec = value;
+            } else if (key == "nr_periods") {
+                current.periods = value;
+                throttling = true;
+            } else if (key == "nr_throttled") {
+                current.throttledPeriods = value;
+            } else if (key == "throttled_usec") {
+                current.throttledUsec = value;
+            }
+            line = end ? end + 1 : line + strlen(line);
+        }
+        info.cpuUsage = haveRate ? static_cast<float>(rate(current.usageUsec, previous.usageUsec) / 1e6 * 100) : 0.0f;
+        if (throttling) {
+            unsigned long long periods = current.periods - std::min(current.periods, previous.periods);
+            unsigned long long throttled = current.throttledPeriods - std::min(current.throttledPeriods,
+                                                                               previous.throttledPeriods);
+            info.throttledPercent = haveRate && periods > 0 ? 100.0f * throttled / periods : 0.0f;
+            info.throttledMsPerSec =
+                haveRate ? static_cast<float>(rate(current.throttledUsec, previous.throttledUsec) / 1000) : 0.0f;
+        }
+    }
+
+    if (readFile(node, path, MemoryCurrent) >= 0) {
+        info.memoryBytes = strtoll(buffer.data(), nullptr, 10);
+    }
+
+    // io.stat: one "major:minor rbytes=N wbytes=N ..." line per device
+    if (readFile(node, path, IoStat) >= 0) {
+        for (const char* field = buffer.data(); (field = strchr(field, '=')) != nullptr; field++) {
+            if (field - buffer.data() >= 6 && strncmp(field - 6, "rbytes", 6) == 0) {
+                current.readBytes += strtoull(field + 1, nullptr, 10);
+            } else if (field - buffer.data() >= 6 && strncmp(field - 6, "wbytes", 6) == 0) {
+                current.writeBytes += strtoull(field + 1, nullptr, 10);
+            }
+        }
+        info.readBytesPerSec = haveRate ? rate(current.readBytes, previous.readBytes) : 0.0;
+        info.writeBytesPerSec = haveRate ? rate(current.writeBytes, previous.writeBytes) : 0.0;
+    }
+
+    // cpu.pressure: "some avg10=N ..." and, on newer kernels, "full avg10=N ..."
+    if (readFile(node, path, CpuPressure) >= 0) {
+        if (const char* some = strstr(buffer.data(), "some avg10=")) {
+            info.cpuPressureSome = strtof(some + 11, nullptr);
+        }
+        if (const char* full = strstr(buffer.data(), "full avg10=")) {
+            info.cpuPressureFull = strtof(full + 11, nullptr);
+        }
+    }
+    node.previous = current;
+
+    const size_t index = out.size();
+    out.push_back(std::move(info));
+
+    if (listChildren(node, path)) {
+        for (auto& [childName, child] : node.children) {
+            walk(*child, path == "." ? childName : path + "/" + childName, childName,
+                 static_cast<int32_t>(index), depth + 1, out, now);
+        }
+    }
+    out[index].subtreeSize = static_cast<uint32_t>(out.size() - index);
+}
+
+/**
+ * Reads every cgroup of the hierarchy
+ *
+ * @param generation Collector pass number
+ * @return Snapshot ready to publish; without cgroup2 it has no nodes and no mount point
+ */
+std::shared_ptr<CgroupSnapshot> CgroupCollector::collect(unsigned long long generation) {
+    auto snapshot = std::make_shared<CgroupSnapshot>();
+    snapshot->generation = generation;
+    snapshot->takenAt = std::chrono::steady_clock::now();
+    snapshot->mountPoint = mountPoint;
+    snapshot->syscalls = 0;
+    if (!available()) {
+        return snapshot;
+    }
+
+    syscalls = 0;
+    snapshot->nodes.reserve(root->children.size() * 4 + 1);
+    walk(*root, ".", "/", -1, 0, snapshot->nodes, snapshot->takenAt);
+    snapshot->syscalls = syscalls;
+    return snapshot;
+}
@@ -0,0 +1,209 @@
+#include "header.h"
+
+// Searches shorter than a trigram cannot use the index
+static constexpr size_t TRIGRAM_LENGTH = 3;
+
+// Dead documents tolerated before the posting lists are rebuilt
+static constexpr size_t MIN_DEAD_DOCUMENTS_TO_COMPACT = 1024;
+
+/**
+ * Packs three lower-cased bytes into a trigram key
+ */
+static uint32_t Trigram(const char* text) {
+    auto lower = [](char c) { return static_cast<uint32_t>(std::tolower(static_cast<unsigned char>(c))); };
+    return (lower(text[0]) << 16) | (lower(text[1]) << 8) | lower(text[2]);
+}
+
+/**
+ * Collects the distinct trigrams of a text
+ *
+ * @param text Text to split
+ * @param trigrams Receives the sorted, deduplicated trigram keys
+ */
+static void CollectTrigrams(std::string_view text, std::vector<uint32_t>& trigrams) {
+    trigrams.clear();
+    for (size_t i = 0; i + TRIGRAM_LENGTH <= text.size(); i++) {
+        trigrams.push_back(Trigram(text.data() + i));
+    }
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+}
+
+/**
+ * Case-insensitive substring test
+ *
+ * @param haystack Text to search
+ * @param lowerNeedle Lower-cased text to find
+ * @return true if haystack contains the needle ignoring case
+ */
+bool ContainsIgnoreCase(std::string_view haystack, std::string_view lowerNeedle) {
+    auto it = std::search(haystack.begin(), haystack.end(), lowerNeedle.begin(), lowerNeedle.end(),
+                          [](char a, char b) { return std::tolower(static_cast<unsigned char>(a)) == b; });
+    return it != haystack.end() || lowerNeedle.empty();
+}
+
+/**
+ * Brings the index in line with the processes of a completed scan
+ * Processes whose identity is unchanged cost one pointer comparison; new,
+ * exec'd or recycled ones are (re)indexed and vanished ones marked dead.
+ *
+ * @param processes Results of the scan (inactive entries are ignored)
+ */
+void CmdlineIndex::sync(const std::vector<ProcessInfo>& processes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    syncCount++;
+
+    for (const ProcessInfo& process : processes) {
+        if (!process.isActive || !process.identity) {
+            continue;
+        }
+        auto it = documentOfPid.find(process.pid);
+        if (it != documentOfPid.end()) {
+            if (documents[it->second].identity == process.identity) {
+                documents[it->second].seenInSync = syncCount;
+                continue;
+            }
+            remove(it->second);
+        }
+        add(process.identity);
+    }
+
+    for (auto it = documentOfPid.begin(); it != documentOfPid.end();) {
+        if (documents[it->second].seenInSync != syncCount) {
+            uint32_t document = it->second;
+            it = documentOfPid.erase(it);
+            documents[document].live = false;
+            documents[document].identity.reset();
+            deadDocuments++;
+        } else {
+            ++it;
+        }
+    }
+
+    if (deadDocuments >= MIN_DEAD_DOCUMENTS_TO_COMPACT && deadDocuments > documentOfPid.size()) {
+        compact();
+    }
+}
+
+/**
+ * Adds a process as a new document
+ *
+ * @param identity Identity holding the command line
+ */
+void CmdlineIndex::add(const std::shared_ptr<const ProcessIdentity>& identity) {
+    uint32_t document = static_cast<uint32_t>(documents.size());
+    documents.push_back(Document{identity, syncCount, true});
+    documentOfPid[identity->pid] = document;
+    indexDocument(document);
+}
+
+/**
+ * Appends a document id to the posting list of each of its trigrams
+ *
+ * @param document Document id, larger than every id already indexed
+ */
+void CmdlineIndex::indexDocument(uint32_t document) {
+    CollectTrigrams(documents[document].identity->cmdline, trigramScratch);
+    for (uint32_t trigram : trigramScratch) {
+        postings[trigram].push_back(document);
+    }
+}
+
+/**
+ * Marks a document dead; its postings are dropped by the next compaction
+ *
+ * @param document Document id
+ */
+void CmdlineIndex::remove(uint32_t document) {
+    documentOfPid.erase(documents[document].identity->pid);
+    documents[document].live = false;
+    documents[document].identity.reset();
+    deadDocuments++;
+}
+
+/**
+ * Renumbers the live documents and rebuilds every posting list
+ */
+void CmdlineIndex::compact() {
+    std::vector<Document> live;
+    live.reserve(documentOfPid.size());
+    for (Document& document : documents) {
+        if (document.live) {
+            live.push_back(std::move(document));
+        }
+    }
+    documents = std::move(live);
+    postings.clear();
+    documentOfPid.clear();
+    for (uint32_t document = 0; document < documents.size(); document++) {
+        documentOfPid[documents[document].identity->pid] = document;
+        indexDocument(document);
+    }
+    deadDocuments = 0;
+}
+
+/**
+ * Finds live processes whose command line contains a string, ignoring case
+ *
+ * @param needle Text to search for
+ * @param matches Receives (pid, starttime) of every matching process
+ * @return false if the needle is shorter than a trigram and the index cannot answer
+ */
+bool CmdlineIndex::search(std::string_view needle, std::vector<std::pair<int, unsigned long long>>& matches) const {
+    matches.clear();
+    if (needle.size() < TRIGRAM_LENGTH) {
+        return false;
+    }
+
+    std::vector<uint32_t> trigrams;
+    CollectTrigrams(needle, trigrams);
+    std::string lowerNeedle(needle);
+    std::transform(lowerNeedle.begin(), lowerNeedle.end(), lowerNeedle.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // Intersect starting from the shortest posting list
+    std::vector<const std::vector<uint32_t>*> lists;
+    for (uint32_t trigram : trigrams) {
+        auto it = postings.find(trigram);
+        if (it == postings.end()) {
+            return true; // Some trigram occurs nowhere
+        }
+        lists.push_back(&it->second);
+    }
+    std::sort(lists.begin(), lists.end(),
+              [](const std::vector<uint32_t>* a, const std::vector<uint32_t>* b) { return a->size() < b->size(); });
+
+    std::vector<size_t> positions(lists.size(), 0);
+    for (uint32_t document : *lists.front()) {
+        bool inAll = true;
+        for (size_t i = 1; i < lists.size() && inAll; i++) {
+            const std::vector<uint32_t>& list = *lists[i];
+            auto it = std::lower_bound(list.begin() + positions[i], list.end(), document);
+            positions[i] = it - list.begin();
+            inAll = it != list.end() && *it == document;
+        }
+        if (!inAll || !documents[document].live) {
+            continue;
+        }
+
+        // Every trigram occurs, but not necessarily consecutively
+        const ProcessIdentity& identity = *documents[document].identity;
+        if (ContainsIgnoreCase(identity.cmdline, lowerNeedle)) {
+            matches.emplace_back(identity.pid, identity.startTime);
+        }
+    }
+    return true;
+}
+
+/**
+ * Returns the number of indexed live processes
+ */
+size_t CmdlineIndex::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return documentOfPid.size();
+}
+
+// Define the global command line index
+CmdlineIndex g_cmdlineIndex;
@@ -0,0 +1,227 @@
+#include "header.h"
+
+// Upper bound on replacement readers spawned for reads that never return
+static constexpr size_t kMaxStuckReaders = 16;
+
+// How long a PID stays quarantined after one of its reads missed the deadline
+static constexpr std::chrono::seconds kQuarantineDuration(30);
+
+/**
+ * Starts the reader threads
+ *
+ * @param readerCount Number of healthy readers to keep available
+ * @param deadline How long a caller waits for a single read
+ */
+DeadlineReader::DeadlineReader(size_t readerCount, std::chrono::milliseconds deadline)
+    : state(std::make_shared<State>()), deadline(deadline) {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->targetReaders = std::max<size_t>(1, readerCount);
+    for (size_t i = 0; i < state->targetReaders; i++) {
+        spawnReaderLocked();
+    }
+}
+
+/**
+ * Asks every reader to exit
+ * Readers are detached because a reader blocked in the kernel cannot be
+ * joined; they share ownership of the state, so it outlives them.
+ */
+DeadlineReader::~DeadlineReader() {
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->stopping = true;
+    }
+    state->requestAvailable.notify_all();
+}
+
+/**
+ * Starts one more reader thread; caller must hold the state mutex
+ */
+void DeadlineReader::spawnReaderLocked() {
+    state->readers++;
+    std::thread(&DeadlineReader::readerLoop, state).detach();
+}
+
+/**
+ * Reads a per-PID file, giving up once the deadline passes
+ * The read itself runs on a reader thread into a buffer owned by the request,
+ * so a caller that times out can return while the read stays blocked. A PID
+ * whose read times out once started is quarantined and a replacement reader
+ * is started. Each calling thread reuses one request, with its own buffer and
+ * condition variable, for as long as its reads complete in time; the caller
+ * parses the result in place instead of copying it out.
+ *
+ * @param pid Process ID
+ * @param file Which per-PID file to read
+ * @param cached Re-sample through the descriptor cache instead of a one-shot open
+ * @param capacity Most bytes to read
+ * @param data Receives the contents; valid until this thread's next read
+ * @return Number of bytes read, -1 if the file could not be read, or TIMED_OUT
+ *         when the outcome is unknown (deadline, quarantine or no healthy reader)
+ */
+ssize_t DeadlineReader::read(int pid, ProcFile file, bool cached, size_t capacity, const char*& data) {
+    // A request abandoned to a blocked reader stays with that reader; the thread starts a new one
+    thread_local std::shared_ptr<Request> request;
+    if (!request || request->abandoned) {
+        request = std::make_shared<Request>();
+    }
+    if (request->data.size() < capacity) {
+        request->data.resize(capacity);
+    }
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    if (isQuarantinedLocked(pid)) {
+        return TIMED_OUT;
+    }
+    if (state->readers == state->stuckReaders) {
+        return TIMED_OUT; // Every reader is blocked in the kernel; queueing would only wait out the deadline
+    }
+    request->pid = pid;
+    request->file = file;
+    request->cached = cached;
+    request->capacity = capacity;
+    request->length = -1;
+    request->started = false;
+    request->done = false;
+    state->requests.push(request);
+    state->requestAvailable.notify_one();
+
+    auto expiry = std::chrono::steady_clock::now() + deadline;
+    if (!request->completed.wait_until(lock, expiry, [&]() { return request->done; })) {
+        request->abandoned = true;
+        if (request->started) {
+            // The read is blocked in the kernel: quarantine the PID and replace the reader
+            state->hungPids[pid] = request.get();
+            state->quarantine[pid] = std::chrono::steady_clock::now() + kQuarantineDuration;
+            state->stuckReaders++;
+            if (state->stuckReaders <= kMaxStuckReaders) {
+                spawnReaderLocked();
+            }
+        }
+        return TIMED_OUT;
+    }
+    data = request->data.data();
+    return request->length;
+}
+
+/**
+ * Checks whether reads of a PID are currently being skipped
+ *
+ * @param pid Process ID
+ * @return true while a read of the PID is still blocked or its quarantine has not expired
+ */
+bool DeadlineReader::isQuarantined(int pid) {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    return isQuarantinedLocked(pid);
+}
+
+/**
+ * Checks whether reads of a PID are currently being skipped; caller must hold the state mutex
+ *
+ * @param pid Process ID
+ * @return true while a read of the PID is still blocked or its quarantine has not expired
+ */
+bool DeadlineReader::isQuarantinedLocked(int pid) {
+    if (state->hungPids.count(pid)) {
+        return true;
+    }
+    auto it = state->quarantine.find(pid);
+    if (it == state->quarantine.end()) {
+        return false;
+    }
+    if (std::chrono::steady_clock::now() >= it->second) {
+        state->quarantine.erase(it); // Give the PID another chance
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Quarantines a PID whose read blocked outside this reader (e.g. a batched read)
+ *
+ * @param pid Process ID
+ */
+void DeadlineReader::quarantine(int pid) {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->quarantine[pid] = std::chrono::steady_clock::now() + kQuarantineDuration;
+}
+
+/**
+ * Counts PIDs that are currently quarantined
+ *
+ * @return Number of quarantined PIDs
+ */
+size_t DeadlineReader::quarantinedCount() {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    auto now = std::chrono::steady_clock::now();
+    size_t count = 0;
+    for (const auto& [pid, releaseTime] : state->quarantine) {
+        if (releaseTime > now || state->hungPids.count(pid)) {
+            count++;
+        }
+    }
+    return count;
+}
+
+/**
+ * Drops the quarantine of a process that has exited
+ * A read of it still blocked is no longer tied to the PID, so a process
+ * that reuses the PID is read normally.
+ *
+ * @param pid Process ID to forget
+ */
+void DeadlineReader::forget(int pid) {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->quarantine.erase(pid);
+    state->hungPids.erase(pid);
+}
+
+/**
+ * Reader thread: performs queued reads until asked to stop
+ * A reader that returns from a read its caller abandoned was counted as
+ * stuck; it exits if a replacement has already taken its place.
+ */
+void DeadlineReader::readerLoop(std::shared_ptr<State> state) {
+    std::unique_lock<std::mutex> lock(state->mutex);
+    while (true) {
+        state->requestAvailable.wait(lock, [&]() { return state->stopping || !state->requests.empty(); });
+        if (state->stopping) {
+            break;
+        }
+
+        std::shared_ptr<Request> request = state->requests.front();
+        state->requests.pop();
+        if (request->abandoned) {
+            continue; // Caller gave up before the read started
+        }
+        request->started = true;
+        lock.unlock();
+
+        ssize_t length = request->cached
+            ? g_procFdCache.read(request->pid, request->file, request->data.data(), request->capacity)
+            : g_procFdCache.readOnce(request->pid, request->file, request->data.data(), request->capacity);
+
+        lock.lock();
+        request->length = length;
+        request->done = true;
+        if (!request->abandoned) {
+            request->completed.notify_one();
+            continue;
+        }
+
+        // This reader was written off as stuck and has come back. The PID may have
+        // been forgotten and hung again in a later process; only its own entry is cleared.
+        auto hung = state->hungPids.find(request->pid);
+        if (hung != state->hungPids.end() && hung->second == request.get()) {
+            state->hungPids.erase(hung);
+        }
+        state->stuckReaders--;
+        if (state->readers - state->stuckReaders > state->targetReaders) {
+            break; // A replacement already took this reader's place
+        }
+    }
+    state->readers--;
+}
+
+// Define the global reader used for /proc files that can block on a process's mm lock
+DeadlineReader g_deadlineReader(std::thread::hardware_concurrency(), PROC_READ_DEADLINE);
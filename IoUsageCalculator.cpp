@@ -0,0 +1,75 @@
+#include "header.h"
+
+/**
+ * Records a new /proc/<pid>/io sample for a process and computes its rates
+ * Rates are the counter deltas since the previous sample divided by the wall
+ * time in between, the same per-PID delta accounting as CPU usage.
+ *
+ * @param pid Process ID the sample belongs to
+ * @param current Freshly read counters and the time they were read at
+ * @return Bytes and syscalls per second, all 0 when there is no previous sample yet
+ */
+IoRates IoUsageCalculator::update(int pid, const ProcessIoStats& current) {
+    ProcessIoStats previous;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto [it, inserted] = previousSamples.try_emplace(pid, current);
+        if (inserted) {
+            return IoRates{0.0f, 0.0f, 0.0f}; // First sighting - rates are known after the next scan
+        }
+        previous = it->second;
+        it->second = current;
+    }
+
+    float elapsedSeconds = std::chrono::duration<float>(current.sampleTime - previous.sampleTime).count();
+    if (previous.startTime != current.startTime || elapsedSeconds <= 0.0f) {
+        return IoRates{0.0f, 0.0f, 0.0f}; // A different process now has this PID, or no time passed
+    }
+
+    // Counters only go backwards if the PID was reused within the same clock tick
+    auto rate = [elapsedSeconds](unsigned long long now, unsigned long long before) {
+        return now > before ? static_cast<float>(now - before) / elapsedSeconds : 0.0f;
+    };
+    return IoRates{rate(current.readBytes, previous.readBytes), rate(current.writeBytes, previous.writeBytes),
+                   rate(current.syscalls, previous.syscalls)};
+}
+
+/**
+ * Tells whether reading the I/O counters of a process was refused before
+ *
+ * @param pid Process ID
+ * @param startTime Start time of the process, so a reused PID is tried again
+ * @return true if the process is known to be unreadable
+ */
+bool IoUsageCalculator::denied(int pid, unsigned long long startTime) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = deniedProcesses.find(pid);
+    return it != deniedProcesses.end() && it->second == startTime;
+}
+
+/**
+ * Remembers that the I/O counters of a process may not be read (they need
+ * ptrace access), so later scans skip it without another failed syscall
+ *
+ * @param pid Process ID
+ * @param startTime Start time of the process
+ */
+void IoUsageCalculator::deny(int pid, unsigned long long startTime) {
+    std::lock_guard<std::mutex> lock(mutex);
+    deniedProcesses[pid] = startTime;
+    previousSamples.erase(pid);
+}
+
+/**
+ * Drops the stored sample of a process that has exited
+ *
+ * @param pid Process ID to forget
+ */
+void IoUsageCalculator::forget(int pid) {
+    std::lock_guard<std::mutex> lock(mutex);
+    previousSamples.erase(pid);
+    deniedProcesses.erase(pid);
+}
+
+// Define the global accountant shared by all collector workers
+IoUsageCalculator g_ioUsageCalculator;
@@ -0,0 +1,170 @@
+#include "header.h"
+#include <fcntl.h>
+#include <sys/syscall.h>
+
+// Layout of the records returned by getdents64(2)
+struct LinuxDirent64 {
+    ino64_t d_ino;
+    off64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+};
+
+// Size of the reusable directory buffer; a few calls cover tens of thousands of PIDs
+static constexpr size_t kDirentBufferSize = 64 * 1024;
+
+PidEnumerator::PidEnumerator() : buffer(kDirentBufferSize) {
+    current.reserve(1000);
+    previous.reserve(1000);
+}
+
+PidEnumerator::~PidEnumerator() {
+    if (procDirFd >= 0) {
+        close(procDirFd);
+    }
+}
+
+/**
+ * Lists the numeric entries of /proc and diffs them against the previous scan
+ * The directory descriptor and record buffer are reused between scans, and
+ * PIDs are decoded straight from the records without building strings.
+ *
+ * @return true on success, false if /proc could not be read (the previous
+ *         PID set is kept and no changes are reported)
+ */
+bool PidEnumerator::scan() {
+    if (procDirFd < 0) {
+        procDirFd = open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (procDirFd < 0) {
+            return false;
+        }
+    } else if (lseek(procDirFd, 0, SEEK_SET) < 0) {
+        return false;
+    }
+    CountProcSyscalls();
+
+    std::swap(previous, current);
+    current.clear();
+
+    while (true) {
+        long bytes = syscall(SYS_getdents64, procDirFd, buffer.data(), buffer.size());
+        CountProcSyscalls();
+        if (bytes < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::swap(previous, current); // Keep the last good set
+            return false;
+        }
+        if (bytes == 0) {
+            break;
+        }
+
+        for (long offset = 0; offset < bytes;) {
+            auto* entry = reinterpret_cast<LinuxDirent64*>(buffer.data() + offset);
+            offset += entry->d_reclen;
+
+            // Only directories with all-digit names are processes
+            if (entry->d_type != DT_DIR || entry->d_name[0] < '1' || entry->d_name[0] > '9') {
+                continue;
+            }
+            int pid = 0;
+            const char* name = entry->d_name;
+            for (; *name >= '0' && *name <= '9'; name++) {
+                pid = pid * 10 + (*name - '0');
+            }
+            if (*name == '\0') {
+                current.push_back(pid);
+            }
+        }
+    }
+
+    std::sort(current.begin(), current.end());
+    diff();
+    return true;
+}
+
+/**
+ * Updates the PID set from process lifecycle events instead of listing /proc
+ * The events come in unordered batches, so a PID found in both lists either
+ * forked and exited, or exited and was reused by a fork. One stat read tells
+ * the two apart. A reused PID that was listed before is a different process
+ * now, so it is reported as both removed and added.
+ *
+ * @param spawned PIDs reported as forked since the last update
+ * @param exited PIDs reported as exited since the last update
+ */
+void PidEnumerator::apply(const std::vector<int>& spawned, const std::vector<int>& exited) {
+    std::swap(previous, current);
+    current.clear();
+
+    gone.assign(exited.begin(), exited.end());
+    std::sort(gone.begin(), gone.end());
+    gone.erase(std::unique(gone.begin(), gone.end()), gone.end());
+
+    // Keep every previous PID that did not exit, then add the new ones
+    for (int pid : previous) {
+        if (!std::binary_search(gone.begin(), gone.end(), pid)) {
+            current.push_back(pid);
+        }
+    }
+    size_t keptCount = current.size();
+    reused.clear();
+    for (int pid : spawned) {
+        if (!std::binary_search(gone.begin(), gone.end(), pid)) {
+            current.push_back(pid);
+        } else if (IsProcessAlive(pid)) {
+            current.push_back(pid);
+            reused.push_back(pid);
+        }
+    }
+
+    // Merge the sorted survivors with the sorted, de-duplicated newcomers
+    std::sort(current.begin() + keptCount, current.end());
+    std::inplace_merge(current.begin(), current.begin() + keptCount, current.end());
+    current.erase(std::unique(current.begin(), current.end()), current.end());
+    diff();
+
+    // Reused PIDs the diff saw as retained start over as new processes
+    bool moved = false;
+    for (int pid : reused) {
+        auto it = std::lower_bound(delta.retained.begin(), delta.retained.end(), pid);
+        if (it != delta.retained.end() && *it == pid) {
+            delta.retained.erase(it);
+            delta.removed.push_back(pid);
+            delta.added.push_back(pid);
+            moved = true;
+        }
+    }
+    if (moved) {
+        std::sort(delta.removed.begin(), delta.removed.end());
+        delta.removed.erase(std::unique(delta.removed.begin(), delta.removed.end()), delta.removed.end());
+        std::sort(delta.added.begin(), delta.added.end());
+        delta.added.erase(std::unique(delta.added.begin(), delta.added.end()), delta.added.end());
+    }
+}
+
+/**
+ * Splits the current PID set into added, removed and retained PIDs
+ * Both sets are sorted, so this is one linear merge walk.
+ */
+void PidEnumerator::diff() {
+    delta.added.clear();
+    delta.removed.clear();
+    delta.retained.clear();
+
+    auto before = previous.begin();
+    auto after = current.begin();
+    while (before != previous.end() || after != current.end()) {
+        if (after == current.end() || (before != previous.end() && *before < *after)) {
+            delta.removed.push_back(*before++);
+        } else if (before == previous.end() || *after < *before) {
+            delta.added.push_back(*after++);
+        } else {
+            delta.retained.push_back(*after);
+            ++before;
+            ++after;
+        }
+    }
+}
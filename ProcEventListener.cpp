@@ -0,0 +1,195 @@
+#include "header.h"
+#include <poll.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/connector.h>
+#include <linux/cn_proc.h>
+
+// How long the receive loop blocks before re-checking whether it should stop
+static constexpr int kPollTimeoutMs = 250;
+
+ProcEventListener::~ProcEventListener() {
+    stop();
+}
+
+/**
+ * Subscribes to fork/exec/exit notifications from the netlink proc connector
+ * and starts the receive thread. This needs CAP_NET_ADMIN, so callers must be
+ * ready to fall back to periodic /proc rescans when it returns false.
+ *
+ * @param onExit Called from the receive thread for every exited process
+ * @return true if events will be delivered
+ */
+bool ProcEventListener::start(std::function<void(int)> onExit) {
+    if (running) {
+        return true;
+    }
+
+    socketFd = socket(PF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_CONNECTOR);
+    if (socketFd < 0) {
+        return false;
+    }
+
+    sockaddr_nl address{};
+    address.nl_family = AF_NETLINK;
+    address.nl_groups = CN_IDX_PROC;
+    address.nl_pid = 0; // Let the kernel assign a unique port id
+    if (bind(socketFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        close(socketFd);
+        socketFd = -1;
+        return false;
+    }
+
+    // Ask the kernel to start multicasting process events to us
+    // Layout: nlmsghdr | cn_msg | proc_cn_mcast_op
+    alignas(nlmsghdr) char request[NLMSG_SPACE(sizeof(cn_msg) + sizeof(proc_cn_mcast_op))] = {};
+    auto* header = reinterpret_cast<nlmsghdr*>(request);
+    header->nlmsg_len = NLMSG_LENGTH(sizeof(cn_msg) + sizeof(proc_cn_mcast_op));
+    header->nlmsg_type = NLMSG_DONE;
+    header->nlmsg_pid = 0;
+    auto* message = static_cast<cn_msg*>(NLMSG_DATA(header));
+    message->id.idx = CN_IDX_PROC;
+    message->id.val = CN_VAL_PROC;
+    message->len = sizeof(proc_cn_mcast_op);
+    proc_cn_mcast_op op = PROC_CN_MCAST_LISTEN;
+    memcpy(message->data, &op, sizeof(op));
+    if (send(socketFd, request, header->nlmsg_len, 0) < 0) {
+        close(socketFd);
+        socketFd = -1;
+        return false;
+    }
+
+    exitCallback = std::move(onExit);
+    running = true;
+    receiver = std::thread(&ProcEventListener::receiveLoop, this);
+    return true;
+}
+
+/**
+ * Stops the receive thread and closes the socket
+ */
+void ProcEventListener::stop() {
+    running = false;
+    if (receiver.joinable()) {
+        receiver.join();
+    }
+    if (socketFd >= 0) {
+        close(socketFd);
+        socketFd = -1;
+    }
+}
+
+/**
+ * Moves all events received since the last call into the caller's batch
+ *
+ * @param batch Receives the pending events; its previous contents are discarded
+ */
+void ProcEventListener::drain(ProcEventBatch& batch) {
+    batch.spawned.clear();
+    batch.execed.clear();
+    batch.exited.clear();
+    batch.overflowed = false;
+
+    // Swapping hands the cleared vectors back so their capacity is reused
+    std::lock_guard<std::mutex> lock(mutex);
+    std::swap(batch, pending);
+}
+
+/**
+ * Records a process exit in the pending batch and notifies the exit callback
+ *
+ * @param pid Process ID that exited
+ */
+void ProcEventListener::reportExit(int pid) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.exited.push_back(pid);
+    }
+    if (exitCallback) {
+        exitCallback(pid);
+    }
+}
+
+/**
+ * Receive thread: decodes connector messages into the pending batch
+ * Only whole processes are tracked. The exit event of a leader thread is
+ * also sent when other threads keep running (e.g. after pthread_exit), so a
+ * leader exit only counts once the process is gone; otherwise the process
+ * exits with its last thread, which is checked for such lingering leaders.
+ */
+void ProcEventListener::receiveLoop() {
+    alignas(nlmsghdr) char buffer[8192];
+
+    while (running) {
+        pollfd pfd{socketFd, POLLIN, 0};
+        int ready = poll(&pfd, 1, kPollTimeoutMs);
+        if (ready <= 0) {
+            continue;
+        }
+
+        ssize_t length = recv(socketFd, buffer, sizeof(buffer), 0);
+        if (length < 0) {
+            if (errno == EINTR || errno == EAGAIN) {
+                continue;
+            }
+            // ENOBUFS means the kernel dropped events; other errors may keep the
+            // socket readable. Either way the PID set must be rebuilt from /proc.
+            lingeringLeaders.clear();
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                pending.overflowed = true;
+            }
+            if (errno != ENOBUFS) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(kPollTimeoutMs));
+            }
+            continue;
+        }
+
+        int remaining = static_cast<int>(length);
+        for (nlmsghdr* header = reinterpret_cast<nlmsghdr*>(buffer);
+             NLMSG_OK(header, remaining);
+             header = NLMSG_NEXT(header, remaining)) {
+            if (header->nlmsg_type == NLMSG_ERROR || header->nlmsg_type == NLMSG_NOOP) {
+                continue;
+            }
+
+            auto* message = static_cast<cn_msg*>(NLMSG_DATA(header));
+            if (message->id.idx != CN_IDX_PROC || message->id.val != CN_VAL_PROC) {
+                continue;
+            }
+            auto* event = reinterpret_cast<proc_event*>(message->data);
+
+            switch (event->what) {
+                case proc_event::PROC_EVENT_FORK:
+                    if (event->event_data.fork.child_pid == event->event_data.fork.child_tgid) {
+                        lingeringLeaders.erase(event->event_data.fork.child_tgid);
+                        std::lock_guard<std::mutex> lock(mutex);
+                        pending.spawned.push_back(event->event_data.fork.child_tgid);
+                    }
+                    break;
+                case proc_event::PROC_EVENT_EXEC: {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    pending.execed.push_back(event->event_data.exec.process_tgid);
+                    break;
+                }
+                case proc_event::PROC_EVENT_EXIT: {
+                    int tgid = event->event_data.exit.process_tgid;
+                    if (event->event_data.exit.process_pid == tgid) {
+                        if (IsProcessAlive(tgid)) {
+                            lingeringLeaders.insert(tgid);
+                        } else {
+                            reportExit(tgid);
+                        }
+                    } else if (!lingeringLeaders.empty() && lingeringLeaders.count(tgid) > 0 &&
+                               !IsProcessAlive(tgid)) {
+                        lingeringLeaders.erase(tgid);
+                        reportExit(tgid);
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+    }
+}
@@ -0,0 +1,222 @@
+#include "header.h"
+#include <fcntl.h>
+#include <sys/resource.h>
+
+// Names of the per-PID files, indexed by ProcFile
+static const char* const kProcFileNames[] = {"stat", "status", "statm", "cmdline", "io", "smaps_rollup"};
+static_assert(sizeof(kProcFileNames) / sizeof(kProcFileNames[0]) == static_cast<size_t>(ProcFile::Count),
+              "kProcFileNames must name every ProcFile");
+
+// Descriptors kept free for everything else the application opens
+static constexpr long kReservedFds = 128;
+
+// Most descriptors the cache keeps open, whatever the limit allows
+static constexpr size_t kMaxCachedFds = 4096;
+
+/**
+ * Closes the wrapped descriptor once the last reader has released it
+ */
+ProcFdCache::CachedFd::~CachedFd() {
+    if (fd >= 0) {
+        close(fd);
+        CountProcSyscalls();
+    }
+}
+
+/**
+ * Opens the /proc directory and sizes the descriptor budget
+ * The budget is half the soft RLIMIT_NOFILE, less a reserve, capped at
+ * kMaxCachedFds. The limit itself is left alone: this runs from a static
+ * initializer, and raising it for the whole process would let descriptors
+ * opened later by SDL, GL or drivers land above FD_SETSIZE.
+ */
+ProcFdCache::ProcFdCache() {
+    procDirFd = open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (procDirFd < 0) {
+        std::cerr << "Failed to open /proc directory." << std::endl;
+    }
+
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+        long softLimit = limit.rlim_cur == RLIM_INFINITY ? 1 << 20 : static_cast<long>(limit.rlim_cur);
+        fdBudget = std::min(kMaxCachedFds, static_cast<size_t>(std::max(16L, softLimit / 2 - kReservedFds)));
+    } else {
+        fdBudget = 256;
+    }
+}
+
+ProcFdCache::~ProcFdCache() {
+    entries.clear();
+    if (procDirFd >= 0) {
+        close(procDirFd);
+    }
+}
+
+/**
+ * Returns the cached descriptor for a PID's file, opening it with openat on a miss
+ * Touching an entry moves it to the front of the LRU list; the least recently
+ * used PIDs are closed once the descriptor budget is exceeded.
+ *
+ * @param pid Process ID
+ * @param file Which per-PID file to open
+ * @return Shared descriptor, or nullptr if the file could not be opened
+ */
+std::shared_ptr<ProcFdCache::CachedFd> ProcFdCache::acquire(int pid, ProcFile file) {
+    size_t index = static_cast<size_t>(file);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(pid);
+        if (it != entries.end()) {
+            lruOrder.splice(lruOrder.begin(), lruOrder, it->second.lruPosition);
+            if (it->second.fds[index]) {
+                return it->second.fds[index];
+            }
+        }
+    }
+
+    // Open outside the lock so workers do not serialize on path lookups
+    char path[32];
+    snprintf(path, sizeof(path), "%d/%s", pid, kProcFileNames[index]);
+    int fd = openat(procDirFd, path, O_RDONLY | O_CLOEXEC);
+    CountProcSyscalls();
+    if (fd < 0) {
+        return nullptr;
+    }
+    auto cached = std::make_shared<CachedFd>(fd);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto [it, inserted] = entries.try_emplace(pid);
+    Entry& entry = it->second;
+    if (inserted) {
+        lruOrder.push_front(pid);
+        entry.lruPosition = lruOrder.begin();
+    }
+    if (entry.fds[index]) {
+        return entry.fds[index]; // Another worker opened it first; ours closes on return
+    }
+    entry.fds[index] = cached;
+    openFds++;
+
+    // Evict whole PIDs from the cold end until we are back under budget
+    while (openFds > fdBudget && lruOrder.size() > 1) {
+        int victim = lruOrder.back();
+        if (victim == pid) {
+            break;
+        }
+        eraseLocked(victim);
+    }
+    return cached;
+}
+
+/**
+ * Drops all descriptors of a PID; caller must hold the mutex
+ */
+void ProcFdCache::eraseLocked(int pid) {
+    auto it = entries.find(pid);
+    if (it == entries.end()) {
+        return;
+    }
+    for (const auto& fd : it->second.fds) {
+        if (fd) {
+            openFds--;
+        }
+    }
+    lruOrder.erase(it->second.lruPosition);
+    entries.erase(it);
+}
+
+/**
+ * Reads a per-PID file from offset 0 into the caller's buffer
+ * Long-lived processes are re-sampled with a single pread on a cached
+ * descriptor. A stale descriptor (the process exited or the PID was reused)
+ * is dropped and the file is reopened once.
+ *
+ * @param pid Process ID
+ * @param file Which per-PID file to read
+ * @param buffer Destination buffer
+ * @param capacity Size of the destination buffer
+ * @return Number of bytes read, or -1 if the file could not be read
+ */
+ssize_t ProcFdCache::read(int pid, ProcFile file, char* buffer, size_t capacity) {
+    for (int attempt = 0; attempt < 2; attempt++) {
+        std::shared_ptr<CachedFd> cached = acquire(pid, file);
+        if (!cached) {
+            return -1;
+        }
+
+        size_t total = 0;
+        bool failed = false;
+        while (total < capacity) {
+            ssize_t n = pread(cached->fd, buffer + total, capacity - total, total);
+            CountProcSyscalls();
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                failed = true;
+                break;
+            }
+            if (n == 0) {
+                break;
+            }
+            total += n;
+        }
+
+        // An empty stat means the task is gone even if pread did not fail
+        if (!failed && (total > 0 || file == ProcFile::Cmdline)) {
+            return static_cast<ssize_t>(total);
+        }
+        forget(pid);
+    }
+    return -1;
+}
+
+/**
+ * Reads a per-PID file without caching its descriptor
+ * Used for files that are read once per process identity, such as cmdline,
+ * so they do not take up room in the descriptor budget.
+ *
+ * @param pid Process ID
+ * @param file Which per-PID file to read
+ * @param buffer Destination buffer
+ * @param capacity Size of the destination buffer
+ * @return Number of bytes read, or -1 if the file could not be read
+ */
+ssize_t ProcFdCache::readOnce(int pid, ProcFile file, char* buffer, size_t capacity) {
+    char path[32];
+    snprintf(path, sizeof(path), "%d/%s", pid, kProcFileNames[static_cast<size_t>(file)]);
+    int fd = openat(procDirFd, path, O_RDONLY | O_CLOEXEC);
+    CountProcSyscalls();
+    if (fd < 0) {
+        return -1;
+    }
+
+    size_t total = 0;
+    while (total < capacity) {
+        ssize_t n = ::read(fd, buffer + total, capacity - total);
+        CountProcSyscalls();
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        total += n;
+    }
+    close(fd);
+    CountProcSyscalls();
+    return static_cast<ssize_t>(total);
+}
+
+/**
+ * Closes every cached descriptor of a PID
+ *
+ * @param pid Process ID that has exited
+ */
+void ProcFdCache::forget(int pid) {
+    std::lock_guard<std::mutex> lock(mutex);
+    eraseLocked(pid);
+}
+
+// Define the global descriptor cache shared by all collector workers
+ProcFdCache g_procFdCache;
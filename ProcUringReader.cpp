@@ -0,0 +1,424 @@
+#include "header.h"
+#include <cassert>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+
+// Submission queue depth; completion queue is twice this by kernel default
+static constexpr unsigned kRingEntries = 256;
+
+// Bytes reserved per file per PID; stat lines and status files fit comfortably
+static constexpr size_t kSlotSize = 4096;
+
+// Per-PID files read by a batch, in slot order: stat, then status or statm
+static constexpr size_t kFilesPerPid = 2;
+
+// Batches the kernel may still write into after their reader was destroyed. They
+// stay allocated until the process exits, when the io-wq workers go away too.
+static std::vector<std::shared_ptr<ProcReadBatch>> parkedBatches;
+
+// user_data layout: generation (24 bits) | slot (32 bits) | operation (8 bits)
+enum UringOp : uint64_t { OpOpen = 1, OpRead = 2, OpClose = 3 };
+
+static uint64_t EncodeUserData(uint32_t generation, size_t slot, UringOp op) {
+    return (static_cast<uint64_t>(generation & 0xFFFFFF) << 40) | (static_cast<uint64_t>(slot) << 8) | op;
+}
+
+/**
+ * Returns the pre-read files of the PID at the given index
+ *
+ * @param index Index into pids
+ * @return Views of the file contents; a view is empty if its read failed
+ */
+ProcPreread ProcReadBatch::get(size_t index) const {
+    ProcPreread preread;
+    size_t statSlot = index * kFilesPerPid;
+    size_t memorySlot = statSlot + 1;
+    if (lengths[statSlot] > 0) {
+        preread.stat = std::string_view(data.data() + statSlot * kSlotSize, lengths[statSlot]);
+    }
+    if (lengths[memorySlot] > 0) {
+        std::string_view contents(data.data() + memorySlot * kSlotSize, lengths[memorySlot]);
+        (memoryFile == ProcFile::Status ? preread.status : preread.statm) = contents;
+    }
+    return preread;
+}
+
+/**
+ * Sets up the ring and maps its queues
+ * Requires IORING_FEAT_EXT_ARG (Linux 5.11+) for timed completion waits;
+ * available() is false when the ring could not be created.
+ */
+ProcUringReader::ProcUringReader() {
+    procDirFd = open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (procDirFd < 0) {
+        return;
+    }
+
+    io_uring_params params{};
+    ringFd = static_cast<int>(syscall(__NR_io_uring_setup, kRingEntries, &params));
+    if (ringFd < 0) {
+        return;
+    }
+    if (!(params.features & IORING_FEAT_EXT_ARG)) {
+        close(ringFd);
+        ringFd = -1;
+        return;
+    }
+    sqEntries = params.sq_entries;
+    cqEntries = params.cq_entries;
+
+    sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool singleMmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (singleMmap) {
+        sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+    }
+
+    sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+    cqRing = singleMmap ? sqRing
+                        : mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_CQ_RING);
+    sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqeMemory = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES);
+    if (sqRing == MAP_FAILED || cqRing == MAP_FAILED || sqeMemory == MAP_FAILED) {
+        releaseRing();
+        return;
+    }
+    sqes = static_cast<io_uring_sqe*>(sqeMemory);
+
+    char* sq = static_cast<char*>(sqRing);
+    sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sqMask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+    char* cq = static_cast<char*>(cqRing);
+    cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cqMask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+}
+
+ProcUringReader::~ProcUringReader() {
+    // Closing the ring does not stop a read already blocked in the kernel from
+    // writing into its buffer later, so batches with late operations are parked
+    for (auto& [generation, batch] : batches) {
+        if (batch->outstanding > 0) {
+            parkedBatches.push_back(std::move(batch));
+        }
+    }
+    batches.clear();
+    releaseRing();
+    if (procDirFd >= 0) {
+        close(procDirFd);
+    }
+}
+
+/**
+ * Unmaps the queues and closes the ring
+ * Closing the ring cancels whatever is still in flight.
+ */
+void ProcUringReader::releaseRing() {
+    if (sqes && sqes != MAP_FAILED) {
+        munmap(sqes, sqesSize);
+    }
+    if (cqRing && cqRing != MAP_FAILED && cqRing != sqRing) {
+        munmap(cqRing, cqRingSize);
+    }
+    if (sqRing && sqRing != MAP_FAILED) {
+        munmap(sqRing, sqRingSize);
+    }
+    sqes = nullptr;
+    sqRing = cqRing = nullptr;
+    if (ringFd >= 0) {
+        close(ringFd);
+        ringFd = -1;
+    }
+}
+
+/**
+ * Queues one operation on the submission ring
+ * The caller guarantees there is room and submits it with io_uring_enter.
+ */
+void ProcUringReader::queue(uint8_t opcode, int fd, uint64_t address, unsigned length, uint64_t userData) {
+    unsigned tail = *sqTail;
+    unsigned index = tail & *sqMask;
+    io_uring_sqe& sqe = sqes[index];
+    memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = opcode;
+    sqe.fd = fd;
+    sqe.addr = address;
+    sqe.len = length;
+    sqe.user_data = userData;
+    if (opcode == IORING_OP_OPENAT) {
+        sqe.open_flags = O_RDONLY | O_CLOEXEC;
+    }
+    sqArray[index] = index;
+    __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+    inFlight++;
+}
+
+/**
+ * Consumes every available completion and routes it to its batch
+ * Completions of a batch that already gave up on them are late: a late open
+ * or read leaves a descriptor behind, which is closed here synchronously.
+ */
+void ProcUringReader::reap() {
+    unsigned head = *cqHead;
+    unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+    for (; head != tail; head++) {
+        const io_uring_cqe& cqe = cqes[head & *cqMask];
+        inFlight--;
+
+        uint32_t generation = static_cast<uint32_t>(cqe.user_data >> 40);
+        size_t slot = static_cast<size_t>((cqe.user_data >> 8) & 0xFFFFFFFF);
+        auto op = static_cast<UringOp>(cqe.user_data & 0xFF);
+
+        auto it = batches.find(generation);
+        if (it == batches.end()) {
+            continue;
+        }
+        ProcReadBatch& batch = *it->second;
+        bool late = batch.lateSlots[slot];
+
+        switch (op) {
+            case OpOpen:
+                if (cqe.res >= 0) {
+                    batch.fds[slot] = cqe.res;
+                    if (late) {
+                        close(cqe.res);
+                        CountProcSyscalls();
+                        batch.fds[slot] = -1;
+                    }
+                }
+                break;
+            case OpRead:
+                batch.lengths[slot] = late ? -1 : cqe.res;
+                if (late && batch.fds[slot] >= 0) {
+                    close(batch.fds[slot]);
+                    CountProcSyscalls();
+                    batch.fds[slot] = -1;
+                }
+                break;
+            case OpClose:
+                batch.fds[slot] = -1;
+                break;
+        }
+        batch.pendingSlots[slot] = false;
+
+        if (--batch.outstanding == 0 && batch.finished) {
+            batches.erase(it); // Last late completion of a parked batch
+        }
+    }
+    __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+}
+
+/**
+ * Returns the number of queued operations the kernel has not consumed yet
+ */
+unsigned ProcUringReader::unsubmitted() const {
+    return *sqTail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * Hands every queued operation of a batch to the kernel without waiting
+ * Whatever the kernel still refuses is taken back off the ring and its slot
+ * left unattempted, so no stale entry is submitted with a later window.
+ *
+ * @param batch Batch the queued operations belong to
+ */
+void ProcUringReader::submitQueued(ProcReadBatch& batch) {
+    unsigned queued = unsubmitted();
+    if (queued > 0) {
+        syscall(__NR_io_uring_enter, ringFd, queued, 0, 0, nullptr, 0);
+        CountProcSyscalls();
+    }
+
+    unsigned head = __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+    unsigned tail = *sqTail;
+    for (; tail != head; tail--) {
+        const io_uring_sqe& sqe = sqes[sqArray[(tail - 1) & *sqMask]];
+        size_t slot = static_cast<size_t>((sqe.user_data >> 8) & 0xFFFFFFFF);
+        batch.pendingSlots[slot] = false;
+        batch.outstanding--;
+        inFlight--;
+    }
+    __atomic_store_n(sqTail, head, __ATOMIC_RELEASE);
+}
+
+/**
+ * Runs one operation over every eligible slot of a batch
+ * Submissions are windowed to the ring size and the whole phase shares one
+ * deadline, checked before each window is queued; slots still pending when
+ * it expires are marked late. Every queued operation is submitted before
+ * returning, so the ring is empty between phases.
+ *
+ * @return Slots whose operation did not complete before the deadline
+ */
+std::vector<size_t> ProcUringReader::runPhase(ProcReadBatch& batch, uint8_t opcode,
+                                              const std::vector<size_t>& slots,
+                                              std::chrono::steady_clock::time_point deadline) {
+    size_t next = 0;
+    size_t phaseOutstanding = 0;
+    UringOp op = opcode == IORING_OP_OPENAT ? OpOpen : opcode == IORING_OP_READ ? OpRead : OpClose;
+
+    while (next < slots.size() || phaseOutstanding > 0) {
+        auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+            break;
+        }
+
+        // Fill the submission ring, never exceeding what the completion ring can hold
+        unsigned queued = 0;
+        while (next < slots.size() && unsubmitted() < sqEntries && inFlight < cqEntries) {
+            size_t slot = slots[next++];
+            uint64_t userData = EncodeUserData(batch.generation, slot, op);
+            if (opcode == IORING_OP_OPENAT) {
+                const char* path = batch.paths.data() + slot * ProcReadBatch::PATH_SIZE;
+                queue(opcode, procDirFd, reinterpret_cast<uint64_t>(path), 0, userData);
+            } else if (opcode == IORING_OP_READ) {
+                char* buffer = batch.data.data() + slot * kSlotSize;
+                queue(opcode, batch.fds[slot], reinterpret_cast<uint64_t>(buffer), kSlotSize, userData);
+            } else {
+                queue(opcode, batch.fds[slot], 0, 0, userData);
+            }
+            batch.pendingSlots[slot] = true;
+            batch.outstanding++;
+            queued++;
+            phaseOutstanding++;
+        }
+
+        auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now);
+        __kernel_timespec timeout{};
+        timeout.tv_sec = remaining.count() / 1000000000;
+        timeout.tv_nsec = remaining.count() % 1000000000;
+        io_uring_getevents_arg waitArg{};
+        waitArg.ts = reinterpret_cast<uint64_t>(&timeout);
+
+        // Submit the window, plus anything an interrupted call left queued, and wait
+        // for it (or for the deadline) in a single call
+        unsigned waitFor = static_cast<unsigned>(std::min<size_t>(phaseOutstanding, cqEntries));
+        long result = syscall(__NR_io_uring_enter, ringFd, unsubmitted(), waitFor,
+                              IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &waitArg, sizeof(waitArg));
+        CountProcSyscalls();
+        if (result < 0 && errno != ETIME && errno != EINTR) {
+            break;
+        }
+
+        size_t before = batch.outstanding;
+        reap();
+        phaseOutstanding -= std::min(phaseOutstanding, before - batch.outstanding);
+
+        if (queued == 0 && inFlight >= cqEntries) {
+            break; // Ring is full of operations from earlier batches that never completed
+        }
+    }
+
+    // A window queued just before an error may not have reached the kernel
+    submitQueued(batch);
+    assert(unsubmitted() == 0);
+
+    // Submitted operations that have not completed are late; the kernel may
+    // still finish them, so their slots are never read or reused by this batch
+    std::vector<size_t> lateSlots;
+    for (size_t slot : slots) {
+        if (batch.pendingSlots[slot]) {
+            batch.lateSlots[slot] = true;
+            lateSlots.push_back(slot);
+        }
+    }
+    return lateSlots;
+}
+
+/**
+ * Reads stat and one memory file of every PID with batched openat, read and close
+ * Each of the three phases goes through the ring in windows of up to 256
+ * operations from the calling thread, so a scan of N PIDs costs about
+ * 3 * 2N / 256 io_uring_enter calls instead of 6N syscalls. Reads that miss
+ * the deadline (a process stuck in D state) leave their PID quarantined.
+ *
+ * @param pids PIDs to read
+ * @param deadline Time budget for each phase
+ * @param memoryFile Status for the memory breakdown, otherwise the much shorter statm
+ * @return Batch holding the file contents, or nullptr if io_uring is unavailable
+ */
+std::shared_ptr<ProcReadBatch> ProcUringReader::readAll(const std::vector<int>& pids,
+                                                        std::chrono::milliseconds deadline,
+                                                        ProcFile memoryFile) {
+    if (!available()) {
+        return nullptr;
+    }
+    reap(); // Collect late completions from earlier batches
+
+    auto batch = std::make_shared<ProcReadBatch>();
+    batch->generation = ++lastGeneration & 0xFFFFFF; // Must round-trip through user_data
+    batch->memoryFile = memoryFile;
+    batch->pids = pids;
+    size_t slotCount = pids.size() * kFilesPerPid;
+    batch->data.resize(slotCount * kSlotSize);
+    batch->paths.resize(slotCount * ProcReadBatch::PATH_SIZE);
+    batch->lengths.assign(slotCount, -2);   // -2: not read yet
+    batch->fds.assign(slotCount, -1);
+    batch->pendingSlots.assign(slotCount, false);
+    batch->lateSlots.assign(slotCount, false);
+    batches[batch->generation] = batch;
+
+    std::vector<size_t> slots;
+    slots.reserve(slotCount);
+    const char* const fileNames[kFilesPerPid] = {"stat", memoryFile == ProcFile::Status ? "status" : "statm"};
+    for (size_t i = 0; i < pids.size(); i++) {
+        for (size_t f = 0; f < kFilesPerPid; f++) {
+            size_t slot = i * kFilesPerPid + f;
+            snprintf(batch->paths.data() + slot * ProcReadBatch::PATH_SIZE, ProcReadBatch::PATH_SIZE,
+                     "%d/%s", pids[i], fileNames[f]);
+            slots.push_back(slot);
+        }
+    }
+
+    // Phase 1: open every file
+    std::vector<size_t> late = runPhase(*batch, IORING_OP_OPENAT, slots,
+                                        std::chrono::steady_clock::now() + deadline);
+
+    // Phase 2: read every file that opened
+    slots.clear();
+    for (size_t slot = 0; slot < slotCount; slot++) {
+        if (batch->fds[slot] >= 0) {
+            slots.push_back(slot);
+        }
+    }
+    std::vector<size_t> lateReads = runPhase(*batch, IORING_OP_READ, slots,
+                                             std::chrono::steady_clock::now() + deadline);
+    late.insert(late.end(), lateReads.begin(), lateReads.end());
+
+    // Phase 3: close every descriptor whose read has finished
+    slots.clear();
+    for (size_t slot = 0; slot < slotCount; slot++) {
+        if (batch->fds[slot] >= 0 && !batch->lateSlots[slot]) {
+            slots.push_back(slot);
+        }
+    }
+    runPhase(*batch, IORING_OP_CLOSE, slots, std::chrono::steady_clock::now() + deadline);
+
+    // Close synchronously whatever the close phase had no time to submit
+    for (size_t slot = 0; slot < slotCount; slot++) {
+        if (batch->fds[slot] >= 0 && !batch->lateSlots[slot] && !batch->pendingSlots[slot]) {
+            close(batch->fds[slot]);
+            CountProcSyscalls();
+            batch->fds[slot] = -1;
+        }
+    }
+
+    // A read that is still blocked after its deadline quarantines its PID
+    for (size_t slot : late) {
+        batch->lengths[slot] = -1;
+        g_deadlineReader.quarantine(pids[slot / kFilesPerPid]);
+    }
+
+    // Keep the batch registered only while the kernel may still write into it
+    batch->finished = true;
+    if (batch->outstanding == 0) {
+        batches.erase(batch->generation);
+    }
+    return batch;
+}
@@ -0,0 +1,243 @@
+#include "header.h"
+
+namespace {
+
+std::string ToLower(std::string_view text) {
+    std::string lower(text);
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return lower;
+}
+
+} // namespace
+
+/**
+ * Recompiles the query and recomputes matches when either input changed
+ *
+ * @param text Filter text as typed
+ * @param latest Snapshot being displayed
+ * @return true if the cached matches were recomputed
+ */
+bool ProcessFilter::update(const char* text, const std::shared_ptr<const ProcessSnapshot>& latest) {
+    bool queryChanged = query != text;
+    if (!queryChanged && latest == snapshot) {
+        return false;
+    }
+    if (queryChanged) {
+        query = text;
+        if (!compile(query)) {
+            terms.clear(); // An incomplete query (e.g. while typing a regex) filters nothing
+        }
+    }
+    snapshot = latest;
+
+    rowMatches.clear();
+    if (terms.empty() || !snapshot) {
+        return true;
+    }
+
+    const ProcessTable& table = snapshot->table;
+    for (Term& term : terms) {
+        if (term.kind == TermKind::Text) {
+            matchText(term, table);
+        }
+    }
+    nameMatches.assign(hasNameTerms ? table.nameCount() : 0, -1);
+    rowMatches.resize(table.size());
+    for (uint32_t row = 0; row < table.size(); row++) {
+        rowMatches[row] = matchesRow(table, row);
+    }
+    return true;
+}
+
+/**
+ * Parses a query into terms
+ *
+ * @param text Query text
+ * @return false with error() set if a term is malformed
+ */
+bool ProcessFilter::compile(const std::string& text) {
+    terms.clear();
+    hasNameTerms = false;
+    compileError.clear();
+
+    std::istringstream words(text);
+    std::string word;
+    while (words >> word) {
+        Term term{};
+
+        if (word.size() >= 2 && word.front() == '/' && word.back() == '/') {
+            term.kind = TermKind::Regex;
+            try {
+                term.pattern = std::regex(word.substr(1, word.size() - 2),
+                                          std::regex::ECMAScript | std::regex::icase | std::regex::optimize);
+            } catch (const std::regex_error& e) {
+                compileError = "Invalid regex " + word + ": " + e.what();
+                return false;
+            }
+        } else if (word.front() == '^') {
+            term.kind = TermKind::Prefix;
+            term.text = ToLower(std::string_view(word).substr(1));
+        } else {
+            size_t split = word.find_first_of(":<>=");
+            if (split == std::string::npos || split == 0) {
+                term.kind = TermKind::Text;
+                term.text = ToLower(word);
+            } else {
+                std::string field = ToLower(std::string_view(word).substr(0, split));
+                std::string_view rest = std::string_view(word).substr(split);
+
+                if (rest.front() == ':' && field == "name") {
+                    term.kind = TermKind::Substring;
+                    term.text = ToLower(rest.substr(1));
+                } else if (rest.front() == ':' && field == "state") {
+                    term.kind = TermKind::State;
+                    term.text = std::string(rest.substr(1));
+                } else if (field == "cpu" || field == "mem" || field == "pid") {
+                    term.kind = TermKind::Numeric;
+                    term.column = field == "cpu" ? ProcessColumn::Cpu
+                                : field == "mem" ? ProcessColumn::Memory
+                                : ProcessColumn::Pid;
+
+                    size_t opLength = rest.size() > 1 && rest[1] == '=' ? 2 : 1;
+                    std::string_view op = rest.substr(0, opLength);
+                    if (op == "<") term.compare = Compare::Less;
+                    else if (op == "<=") term.compare = Compare::LessEqual;
+                    else if (op == ">") term.compare = Compare::Greater;
+                    else if (op == ">=") term.compare = Compare::GreaterEqual;
+                    else if (op == "=" || op == ":") term.compare = Compare::Equal;
+                    else {
+                        compileError = "Invalid comparison in " + word;
+                        return false;
+                    }
+
+                    std::string number(rest.substr(opLength));
+                    char* end = nullptr;
+                    term.value = std::strtod(number.c_str(), &end);
+                    if (number.empty() || *end != '\0') {
+                        compileError = "Expected a number in " + word;
+                        return false;
+                    }
+                } else {
+                    // Not a field (e.g. "kworker/0:1") - search for the whole word
+                    term.kind = TermKind::Text;
+                    term.text = ToLower(word);
+                }
+            }
+        }
+
+        hasNameTerms |= term.kind == TermKind::Substring || term.kind == TermKind::Prefix ||
+                        term.kind == TermKind::Regex;
+        terms.push_back(std::move(term));
+    }
+    return true;
+}
+
+/**
+ * Finds the rows whose name or command line contains a text term
+ * Command lines are looked up in the trigram index; terms shorter than a
+ * trigram scan the command lines directly.
+ *
+ * @param term Text term, receives one result per row
+ * @param table Table of the current snapshot
+ */
+void ProcessFilter::matchText(Term& term, const ProcessTable& table) {
+    term.rows.assign(table.size(), 0);
+
+    std::vector<int8_t> nameHits(table.nameCount(), -1);
+    for (uint32_t row = 0; row < table.size(); row++) {
+        int8_t& hit = nameHits[table.nameIds()[row]];
+        if (hit < 0) {
+            hit = ContainsIgnoreCase(table.name(row), term.text) ? 1 : 0;
+        }
+        term.rows[row] = hit;
+    }
+
+    std::vector<std::pair<int, unsigned long long>> hits;
+    if (g_cmdlineIndex.search(term.text, hits)) {
+        for (const auto& hit : hits) {
+            ptrdiff_t row = table.find(hit.first);
+            if (row >= 0 && table.startTimes()[row] == hit.second) {
+                term.rows[row] = 1;
+            }
+        }
+    } else {
+        for (uint32_t row = 0; row < table.size(); row++) {
+            if (!term.rows[row] && ContainsIgnoreCase(table.cmdline(row), term.text)) {
+                term.rows[row] = 1;
+            }
+        }
+    }
+}
+
+/**
+ * Evaluates every name term against one name
+ *
+ * @param name Process name
+ * @return true if all name terms match
+ */
+bool ProcessFilter::matchesName(const std::string& name) const {
+    std::string lower = ToLower(name);
+    for (const Term& term : terms) {
+        switch (term.kind) {
+            case TermKind::Substring:
+                if (lower.find(term.text) == std::string::npos) return false;
+                break;
+            case TermKind::Prefix:
+                if (lower.compare(0, term.text.size(), term.text) != 0) return false;
+                break;
+            case TermKind::Regex:
+                if (!std::regex_search(name, term.pattern)) return false;
+                break;
+            default:
+                break;
+        }
+    }
+    return true;
+}
+
+/**
+ * Evaluates the whole query against one row
+ * Name terms are looked up in the per-name cache, filled on first use.
+ *
+ * @param table Table of the current snapshot
+ * @param row Row index
+ * @return true if every term matches
+ */
+bool ProcessFilter::matchesRow(const ProcessTable& table, uint32_t row) {
+    for (const Term& term : terms) {
+        if (term.kind == TermKind::Text) {
+            if (!term.rows[row]) {
+                return false;
+            }
+        } else if (term.kind == TermKind::State) {
+            if (term.text.find(ProcStateLabel(table.states()[row])[0]) == std::string::npos) {
+                return false;
+            }
+        } else if (term.kind == TermKind::Numeric) {
+            double value = term.column == ProcessColumn::Cpu    ? table.cpu()[row]
+                         : term.column == ProcessColumn::Memory ? table.mem()[row]
+                         : table.pids()[row];
+            bool matched = false;
+            switch (term.compare) {
+                case Compare::Less:         matched = value < term.value; break;
+                case Compare::LessEqual:    matched = value <= term.value; break;
+                case Compare::Greater:      matched = value > term.value; break;
+                case Compare::GreaterEqual: matched = value >= term.value; break;
+                case Compare::Equal:        matched = value == term.value; break;
+            }
+            if (!matched) {
+                return false;
+            }
+        }
+    }
+
+    if (hasNameTerms) {
+        int8_t& cached = nameMatches[table.nameIds()[row]];
+        if (cached < 0) {
+            cached = matchesName(table.name(row)) ? 1 : 0;
+        }
+        return cached == 1;
+    }
+    return true;
+}
@@ -0,0 +1,97 @@
+#include "header.h"
+
+/**
+ * Reads /proc/<pid>/cmdline and extracts the executable basename from its first argument
+ * The read is deadline-bounded; quarantined PIDs are not read at all.
+ *
+ * @param pid Process ID
+ * @param fallback Name to use when cmdline is empty (kernel threads, zombies)
+ * @param timedOut Set when cmdline could not be read, so the fallback is only provisional
+ * @param cmdline Receives the full command line with arguments separated by spaces
+ * @return Executable name without its directory
+ */
+static std::string ReadCommandLine(int pid, std::string_view fallback, bool& timedOut, std::string& cmdline) {
+    // A read that timed out, or was not tried because the PID is quarantined or every
+    // reader is blocked, says nothing about the process, so its fallback name is provisional
+    const char* cmdBuffer = nullptr;
+    ssize_t cmdLength = g_deadlineReader.read(pid, ProcFile::Cmdline, false, PROC_CMDLINE_BUFFER_SIZE, cmdBuffer);
+    timedOut = cmdLength == DeadlineReader::TIMED_OUT;
+    if (cmdLength <= 0) {
+        return std::string(fallback);
+    }
+
+    // Arguments are NUL-separated (and NUL-terminated); keep them space-separated
+    cmdline.assign(cmdBuffer, cmdLength);
+    while (!cmdline.empty() && cmdline.back() == '\0') {
+        cmdline.pop_back();
+    }
+    std::replace(cmdline.begin(), cmdline.end(), '\0', ' ');
+
+    // The executable is the first NUL-terminated argument
+    std::string_view cmdLine(cmdBuffer, strnlen(cmdBuffer, cmdLength));
+    if (cmdLine.empty()) {
+        return std::string(fallback);
+    }
+
+    // Extract just the executable name without the full path
+    size_t lastSlash = cmdLine.find_last_of('/');
+    if (lastSlash != std::string_view::npos) {
+        return std::string(cmdLine.substr(lastSlash + 1));
+    }
+    return std::string(cmdLine);
+}
+
+/**
+ * Returns the identity of a process, reading cmdline only when needed
+ * The cached identity is reused while the PID's starttime and comm are
+ * unchanged and no exec was reported for it. A different starttime means the
+ * PID was recycled; a different comm means the process has exec'd. A
+ * provisional name is retried once the PID leaves quarantine.
+ *
+ * @param pid Process ID
+ * @param stat Freshly parsed stat fields of the process
+ * @return Shared, immutable identity of the process
+ */
+std::shared_ptr<const ProcessIdentity> ProcessIdentityCache::resolve(int pid, const ProcStat& stat) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = identities.find(pid);
+        if (it != identities.end() && it->second->startTime == stat.startTime && it->second->comm == stat.comm &&
+            (!it->second->provisional || g_deadlineReader.isQuarantined(pid))) {
+            return it->second;
+        }
+    }
+
+    // First sight, recycled PID or exec - fetch the name again
+    auto identity = std::make_shared<ProcessIdentity>();
+    identity->pid = pid;
+    identity->startTime = stat.startTime;
+    identity->comm = std::string(stat.comm);
+    identity->name = ReadCommandLine(pid, stat.comm, identity->provisional, identity->cmdline);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    identities[pid] = identity;
+    return identity;
+}
+
+/**
+ * Marks a process as having exec'd so its name is fetched again on the next scan
+ *
+ * @param pid Process ID reported by an exec event
+ */
+void ProcessIdentityCache::invalidate(int pid) {
+    forget(pid);
+}
+
+/**
+ * Drops the identity of a process that has exited
+ *
+ * @param pid Process ID to forget
+ */
+void ProcessIdentityCache::forget(int pid) {
+    std::lock_guard<std::mutex> lock(mutex);
+    identities.erase(pid);
+}
+
+// Define the global identity cache shared by all collector workers
+ProcessIdentityCache g_processIdentities;
@@ -8,13 +8,9 @@
  */
 void ProcessInfoQueue::push(ProcessInfo&& item) {
     // Lock the mutex to ensure thread safety
-    std::unique_lock<std::mutex> lock(mutex);
-    // Move the item onto the queue
+    std::lock_guard<std::mutex> lock(mutex);
+    // Move the item onto the queue (consumers poll with try_pop)
     queue.push(std::move(item));
-    // Unlock before notification to reduce contention
-    lock.unlock();
-    // Notify one waiting thread that data is available
-    cond.notify_one();
 }
 
 /**
@@ -38,5 +34,5 @@ bool ProcessInfoQueue::try_pop(ProcessInfo& item) {
     return true;
 }
 
-// Define the global queue for storing completed process information
-ProcessInfoQueue g_completedProcesses;
\ No newline at end of file
+// Define the global queue of processes reported as exited between scans
+ProcessInfoQueue g_exitedProcesses;
\ No newline at end of file
@@ -0,0 +1,224 @@
+#include "header.h"
+
+namespace {
+
+// Orders rows of one table by the selected column, ties broken by PID
+struct RowLess {
+    const ProcessTable* table;
+    ProcessSortSpec spec;
+
+    bool operator()(uint32_t a, uint32_t b) const {
+        int order = compareKeys(a, b);
+        if (order != 0) {
+            return spec.descending ? order > 0 : order < 0;
+        }
+        return table->pids()[a] < table->pids()[b];
+    }
+
+    int compareKeys(uint32_t a, uint32_t b) const {
+        switch (spec.column) {
+            case ProcessColumn::Pid:
+                return compare(table->pids()[a], table->pids()[b]);
+            case ProcessColumn::Name:
+                if (table->nameIds()[a] == table->nameIds()[b]) {
+                    return 0;
+                }
+                return table->name(a).compare(table->name(b));
+            case ProcessColumn::State:
+                return compare(table->states()[a], table->states()[b]);
+            case ProcessColumn::Cpu:
+                return compare(table->cpu()[a], table->cpu()[b]);
+            case ProcessColumn::Memory:
+                return compare(table->mem()[a], table->mem()[b]);
+            case ProcessColumn::IoRead:
+                return compare(table->ioRead()[a], table->ioRead()[b]);
+            case ProcessColumn::IoWrite:
+                return compare(table->ioWrite()[a], table->ioWrite()[b]);
+            case ProcessColumn::IoSyscalls:
+                return compare(table->ioSyscalls()[a], table->ioSyscalls()[b]);
+            case ProcessColumn::Rss:
+                return compare(table->rss()[a], table->rss()[b]);
+            case ProcessColumn::RssAnon:
+                return compare(table->rssAnon()[a], table->rssAnon()[b]);
+            case ProcessColumn::RssFile:
+                return compare(table->rssFile()[a], table->rssFile()[b]);
+            case ProcessColumn::RssShmem:
+                return compare(table->rssShmem()[a], table->rssShmem()[b]);
+            case ProcessColumn::Swap:
+                return compare(table->swap()[a], table->swap()[b]);
+            case ProcessColumn::Threads:
+                return compare(table->threads()[a], table->threads()[b]);
+            case ProcessColumn::Pss:
+                return compare(table->pss()[a], table->pss()[b]);
+            case ProcessColumn::Uss:
+                return compare(table->uss()[a], table->uss()[b]);
+        }
+        return 0;
+    }
+
+    template <typename T>
+    static int compare(T a, T b) {
+        return a < b ? -1 : (b < a ? 1 : 0);
+    }
+};
+
+/**
+ * Checks whether a row kept its sort key between two snapshots
+ *
+ * @param column Sort column
+ * @param before Previous table
+ * @param oldRow Row of the process in the previous table
+ * @param after Latest table
+ * @param newRow Row of the same PID in the latest table
+ * @return true if the row sorts exactly as before
+ */
+bool SameSortKey(ProcessColumn column, const ProcessTable& before, uint32_t oldRow,
+                 const ProcessTable& after, uint32_t newRow) {
+    switch (column) {
+        case ProcessColumn::Pid:    return true; // Rows were matched by PID
+        case ProcessColumn::Name:   return before.nameIds()[oldRow] == after.nameIds()[newRow];
+        case ProcessColumn::State:  return before.states()[oldRow] == after.states()[newRow];
+        case ProcessColumn::Cpu:    return before.cpu()[oldRow] == after.cpu()[newRow];
+        case ProcessColumn::Memory: return before.mem()[oldRow] == after.mem()[newRow];
+        case ProcessColumn::IoRead: return before.ioRead()[oldRow] == after.ioRead()[newRow];
+        case ProcessColumn::IoWrite: return before.ioWrite()[oldRow] == after.ioWrite()[newRow];
+        case ProcessColumn::IoSyscalls: return before.ioSyscalls()[oldRow] == after.ioSyscalls()[newRow];
+        case ProcessColumn::Rss:    return before.rss()[oldRow] == after.rss()[newRow];
+        case ProcessColumn::RssAnon: return before.rssAnon()[oldRow] == after.rssAnon()[newRow];
+        case ProcessColumn::RssFile: return before.rssFile()[oldRow] == after.rssFile()[newRow];
+        case ProcessColumn::RssShmem: return before.rssShmem()[oldRow] == after.rssShmem()[newRow];
+        case ProcessColumn::Swap:   return before.swap()[oldRow] == after.swap()[newRow];
+        case ProcessColumn::Threads: return before.threads()[oldRow] == after.threads()[newRow];
+        case ProcessColumn::Pss:    return before.pss()[oldRow] == after.pss()[newRow];
+        case ProcessColumn::Uss:    return before.uss()[oldRow] == after.uss()[newRow];
+    }
+    return false;
+}
+
+} // namespace
+
+/**
+ * Brings the order up to date with the latest snapshot and sort spec
+ *
+ * @param latest Snapshot being displayed
+ * @param latestSpec Sort column and direction selected in the table header
+ * @return true if the order was recomputed
+ */
+bool ProcessOrder::update(const std::shared_ptr<const ProcessSnapshot>& latest, const ProcessSortSpec& latestSpec) {
+    if (latest == snapshot && latestSpec == spec) {
+        return false;
+    }
+
+    std::shared_ptr<const ProcessSnapshot> previous = std::move(snapshot);
+    bool specChanged = latestSpec != spec;
+    snapshot = latest;
+    spec = latestSpec;
+
+    if (!snapshot) {
+        order.clear();
+    } else if (previous && !specChanged) {
+        sortIncremental(previous->table);
+    } else {
+        sortAll();
+    }
+    return true;
+}
+
+/**
+ * Sorts every row of the current snapshot from scratch
+ */
+void ProcessOrder::sortAll() {
+    order.resize(snapshot->table.size());
+    for (uint32_t row = 0; row < order.size(); row++) {
+        order[row] = row;
+    }
+    sortRows(order);
+}
+
+/**
+ * Derives the order of the current snapshot from the order of the previous one
+ * Rows are matched by PID. Those with an unchanged key are still in order
+ * relative to each other; only new and changed rows are sorted, then both
+ * runs are merged. Falls back to a full sort when most rows changed.
+ *
+ * @param previous Table the current order was computed for
+ */
+void ProcessOrder::sortIncremental(const ProcessTable& previous) {
+    const ProcessTable& table = snapshot->table;
+    retained.clear();
+    changed.clear();
+    seen.assign(table.size(), 0);
+
+    for (uint32_t oldRow : order) {
+        ptrdiff_t newRow = table.find(previous.pids()[oldRow]);
+        if (newRow < 0) {
+            continue; // Process is gone
+        }
+        seen[newRow] = 1;
+        if (previous.startTimes()[oldRow] == table.startTimes()[newRow] &&
+            SameSortKey(spec.column, previous, oldRow, table, static_cast<uint32_t>(newRow))) {
+            retained.push_back(static_cast<uint32_t>(newRow));
+        } else {
+            changed.push_back(static_cast<uint32_t>(newRow));
+        }
+    }
+    for (uint32_t row = 0; row < seen.size(); row++) {
+        if (!seen[row]) {
+            changed.push_back(row); // Process appeared since the previous scan
+        }
+    }
+
+    if (changed.size() > table.size() / 2) {
+        sortAll();
+        return;
+    }
+
+    sortRows(changed);
+    order.resize(table.size());
+    std::merge(retained.begin(), retained.end(), changed.begin(), changed.end(), order.begin(),
+               RowLess{&table, spec});
+}
+
+/**
+ * Sorts row indices of the current snapshot
+ * Large inputs are cut into one chunk per pool worker, the chunks sorted in
+ * parallel, then merged pairwise in parallel rounds.
+ *
+ * @param rows Row indices to sort in place
+ */
+void ProcessOrder::sortRows(std::vector<uint32_t>& rows) {
+    RowLess less{&snapshot->table, spec};
+    if (rows.size() < PARALLEL_SORT_THRESHOLD) {
+        std::sort(rows.begin(), rows.end(), less);
+        return;
+    }
+
+    if (!sortPool) {
+        sortPool = std::make_unique<ThreadPool>(std::max(2u, std::thread::hardware_concurrency()));
+    }
+
+    size_t chunks = sortPool->size();
+    size_t chunkSize = (rows.size() + chunks - 1) / chunks;
+    std::vector<size_t> bounds(chunks + 1);
+    for (size_t i = 0; i <= chunks; i++) {
+        bounds[i] = std::min(rows.size(), i * chunkSize);
+    }
+
+    for (size_t i = 0; i < chunks; i++) {
+        sortPool->submit([&rows, &bounds, &less, i]() {
+            std::sort(rows.begin() + bounds[i], rows.begin() + bounds[i + 1], less);
+        });
+    }
+    sortPool->waitIdle();
+
+    for (size_t width = 1; width < chunks; width *= 2) {
+        for (size_t i = 0; i + width < chunks; i += 2 * width) {
+            size_t end = std::min(i + 2 * width, chunks);
+            sortPool->submit([&rows, &bounds, &less, i, width, end]() {
+                std::inplace_merge(rows.begin() + bounds[i], rows.begin() + bounds[i + width],
+                                   rows.begin() + bounds[end], less);
+            });
+        }
+        sortPool->waitIdle();
+    }
+}
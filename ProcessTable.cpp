@@ -0,0 +1,158 @@
+#include "header.h"
+
+/**
+ * Converts the state letter of /proc/<pid>/stat to a ProcState
+ *
+ * @param state State character (R, S, D, Z, T, t, X, I)
+ * @return Matching state, or Unknown for anything else
+ */
+ProcState ProcStateFromChar(char state) {
+    switch (state) {
+        case 'R': return ProcState::Running;
+        case 'S': return ProcState::Sleeping;
+        case 'D': return ProcState::DiskSleep;
+        case 'Z': return ProcState::Zombie;
+        case 'T': return ProcState::Stopped;
+        case 't': return ProcState::TracingStop;
+        case 'X': return ProcState::Dead;
+        case 'I': return ProcState::Idle;
+        default:  return ProcState::Unknown;
+    }
+}
+
+/**
+ * Returns the display label of a process state
+ *
+ * @param state Process state
+ * @return Static string with the state letter, as shown by ps/top
+ */
+const char* ProcStateLabel(ProcState state) {
+    static const char* const labels[] = {"R", "S", "D", "Z", "T", "t", "X", "I", "?"};
+    return labels[static_cast<uint8_t>(state)];
+}
+
+/**
+ * Returns the id of a name, assigning a new one on first sight
+ *
+ * @param name Name to intern
+ * @return Stable id of the name
+ */
+uint32_t NameInterner::intern(const std::string& name) {
+    auto it = ids.find(name);
+    if (it != ids.end()) {
+        return it->second;
+    }
+    uint32_t id = static_cast<uint32_t>(names.size());
+    names.push_back(name);
+    ids.emplace(name, id);
+    return id;
+}
+
+/**
+ * Creates an empty table whose name ids refer to the given interner
+ *
+ * @param names Interner holding every name id appended to this table
+ */
+ProcessTable::ProcessTable(std::shared_ptr<const NameInterner> names) : names(std::move(names)) {}
+
+/**
+ * Preallocates every column for the expected number of rows
+ *
+ * @param rows Expected row count
+ */
+void ProcessTable::reserve(size_t rows) {
+    rowOfPid.reserve(rows);
+    pidColumn.reserve(rows);
+    ppidColumn.reserve(rows);
+    startTimeColumn.reserve(rows);
+    nameIdColumn.reserve(rows);
+    stateColumn.reserve(rows);
+    cpuColumn.reserve(rows);
+    memColumn.reserve(rows);
+    ioReadColumn.reserve(rows);
+    ioWriteColumn.reserve(rows);
+    ioSyscallColumn.reserve(rows);
+    rssColumn.reserve(rows);
+    rssAnonColumn.reserve(rows);
+    rssFileColumn.reserve(rows);
+    rssShmemColumn.reserve(rows);
+    swapColumn.reserve(rows);
+    threadColumn.reserve(rows);
+    pssColumn.reserve(rows);
+    ussColumn.reserve(rows);
+    pssSampledAtColumn.reserve(rows);
+    identityColumn.reserve(rows);
+}
+
+/**
+ * Estimates the heap memory the table holds, for benchmarks
+ * Counts the allocated capacity of every column and the PID index, whose
+ * nodes are taken as a key, a value and a next pointer. Identities and
+ * names are shared with the collector and other snapshots and not counted.
+ *
+ * @return Approximate bytes allocated by this table
+ */
+size_t ProcessTable::memoryBytes() const {
+    auto bytes = [](const auto& column) { return column.capacity() * sizeof(column[0]); };
+    size_t total = rowOfPid.bucket_count() * sizeof(void*) +
+                   rowOfPid.size() * (sizeof(std::pair<const int, uint32_t>) + sizeof(void*));
+    total += bytes(pidColumn) + bytes(ppidColumn) + bytes(startTimeColumn) + bytes(nameIdColumn) +
+             bytes(stateColumn) + bytes(cpuColumn) + bytes(memColumn);
+    total += bytes(ioReadColumn) + bytes(ioWriteColumn) + bytes(ioSyscallColumn);
+    total += bytes(rssColumn) + bytes(rssAnonColumn) + bytes(rssFileColumn) + bytes(rssShmemColumn) +
+             bytes(swapColumn) + bytes(threadColumn);
+    total += bytes(pssColumn) + bytes(ussColumn) + bytes(pssSampledAtColumn) + bytes(identityColumn);
+    return total;
+}
+
+/**
+ * Finds the row of a process
+ *
+ * @param pid Process ID
+ * @return Row index, or -1 if the PID is not in the table
+ */
+ptrdiff_t ProcessTable::find(int pid) const {
+    auto it = rowOfPid.find(pid);
+    return it == rowOfPid.end() ? -1 : static_cast<ptrdiff_t>(it->second);
+}
+
+/**
+ * Appends a process as a new row
+ *
+ * @param process Collected process information (its PID must not be in the table yet)
+ * @param nameId Id of process.name in the table's interner
+ */
+void ProcessTable::append(const ProcessInfo& process, uint32_t nameId) {
+    rowOfPid.emplace(process.pid, static_cast<uint32_t>(size()));
+    pidColumn.push_back(process.pid);
+    ppidColumn.push_back(process.ppid);
+    startTimeColumn.push_back(process.startTime);
+    nameIdColumn.push_back(nameId);
+    stateColumn.push_back(process.state);
+    cpuColumn.push_back(process.cpuUsage);
+    memColumn.push_back(process.memoryUsage);
+    ioReadColumn.push_back(process.readBytesPerSec);
+    ioWriteColumn.push_back(process.writeBytesPerSec);
+    ioSyscallColumn.push_back(process.ioSyscallsPerSec);
+    rssColumn.push_back(process.memory.rssKb);
+    rssAnonColumn.push_back(process.memory.anonKb);
+    rssFileColumn.push_back(process.memory.fileKb);
+    rssShmemColumn.push_back(process.memory.shmemKb);
+    swapColumn.push_back(process.memory.swapKb);
+    threadColumn.push_back(process.memory.threads);
+    pssColumn.push_back(process.pss.pssKb);
+    ussColumn.push_back(process.pss.ussKb);
+    pssSampledAtColumn.push_back(process.pss.sampledAt);
+    identityColumn.push_back(process.identity);
+}
+
+/**
+ * Returns the full command line of a row
+ *
+ * @param row Row index
+ * @return Command line, empty for kernel threads or when it could not be read
+ */
+const std::string& ProcessTable::cmdline(size_t row) const {
+    static const std::string none;
+    return identityColumn[row] ? identityColumn[row]->cmdline : none;
+}
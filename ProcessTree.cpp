@@ -0,0 +1,163 @@
+#include "header.h"
+
+// Depth of rows not reached yet while laying out
+static constexpr uint32_t UNPLACED = UINT32_MAX;
+
+/**
+ * Records the parent of a sampled process, moving it if it was reparented
+ *
+ * @param pid Sampled process
+ * @param ppid Parent read from its stat file
+ */
+void ProcessTree::update(int pid, int ppid) {
+    // Node references stay valid when the map grows, so node survives nodes[ppid] below
+    Node& node = nodes[pid];
+    if (node.parent == ppid) {
+        return;
+    }
+    if (node.parent > 0) {
+        unlink(pid, node.parent);
+    }
+    node.parent = ppid;
+    if (ppid > 0 && ppid != pid) {
+        // The parent gets a placeholder node if it has not been sampled yet
+        std::vector<int>& siblings = nodes[ppid].children;
+        siblings.insert(std::lower_bound(siblings.begin(), siblings.end(), pid), pid);
+    }
+}
+
+/**
+ * Drops a process that exited
+ * Its children are reparented by the kernel; they are returned so they can be
+ * sampled again and linked under their new parent.
+ *
+ * @param pid Process that exited
+ * @param orphans Output, children of the process (cleared first)
+ */
+void ProcessTree::remove(int pid, std::vector<int>& orphans) {
+    orphans.clear();
+    auto it = nodes.find(pid);
+    if (it == nodes.end()) {
+        return;
+    }
+    orphans.swap(it->second.children);
+    int parent = it->second.parent;
+    nodes.erase(it);
+    if (parent > 0) {
+        unlink(pid, parent);
+    }
+
+    for (int orphan : orphans) {
+        auto child = nodes.find(orphan);
+        if (child != nodes.end()) {
+            child->second.parent = -1;
+        }
+    }
+}
+
+/**
+ * Removes a process from the children of its former parent
+ * A placeholder parent that was never sampled is dropped with its last child.
+ *
+ * @param pid Child process
+ * @param parent Former parent
+ */
+void ProcessTree::unlink(int pid, int parent) {
+    auto it = nodes.find(parent);
+    if (it == nodes.end()) {
+        return;
+    }
+    std::vector<int>& siblings = it->second.children;
+    auto child = std::lower_bound(siblings.begin(), siblings.end(), pid);
+    if (child != siblings.end() && *child == pid) {
+        siblings.erase(child);
+    }
+    if (siblings.empty() && it->second.parent == -1) {
+        nodes.erase(it);
+    }
+}
+
+/**
+ * Lays out the rows of a snapshot as a forest and aggregates each subtree
+ * Rows whose parent is not listed are roots. The walk visits every row once
+ * and the totals are summed in one reverse pass over the pre-order, where
+ * every child comes after its parent, so the whole layout is linear.
+ *
+ * @param table Rows of the snapshot, sampled with the PIDs this index holds
+ * @param out Layout indexed by row, replaced
+ */
+void ProcessTree::layout(const ProcessTable& table, ProcessTreeLayout& out) {
+    const size_t rows = table.size();
+    const std::vector<int>& pids = table.pids();
+    const std::vector<int>& ppids = table.ppids();
+
+    out.preorder.clear();
+    out.preorder.reserve(rows);
+    out.parentRow.assign(rows, -1);
+    out.depth.assign(rows, UNPLACED);
+    out.subtreeSize.assign(rows, 1);
+    out.subtreeCpu = table.cpu();
+    out.subtreeMem = table.mem();
+
+    // Depth-first from a root; rows are marked when pushed so none is visited twice
+    auto walk = [&](uint32_t root) {
+        out.depth[root] = 0;
+        stack.clear();
+        stack.emplace_back(root, 0);
+        while (!stack.empty()) {
+            auto [row, depth] = stack.back();
+            stack.pop_back();
+            out.preorder.push_back(row);
+
+            auto node = nodes.find(pids[row]);
+            if (node == nodes.end()) {
+                continue;
+            }
+            // Pushed in reverse so the lowest PID is visited first
+            const std::vector<int>& children = node->second.children;
+            for (auto child = children.rbegin(); child != children.rend(); ++child) {
+                ptrdiff_t childRow = table.find(*child);
+                if (childRow < 0 || out.depth[childRow] != UNPLACED || ppids[childRow] != pids[row]) {
+                    continue;
+                }
+                out.depth[childRow] = depth + 1;
+                out.parentRow[childRow] = static_cast<int32_t>(row);
+                stack.emplace_back(static_cast<uint32_t>(childRow), depth + 1);
+            }
+        }
+    };
+
+    for (uint32_t row = 0; row < rows; row++) {
+        if (ppids[row] == pids[row] || table.find(ppids[row]) < 0) {
+            walk(row);
+        }
+    }
+    // Rows left over hang below a parent cycle, possible when PIDs are reused between
+    // samples. Follow parents until one repeats; walking from it places the whole cycle.
+    for (uint32_t row = 0; row < rows; row++) {
+        if (out.depth[row] != UNPLACED) {
+            continue;
+        }
+        ptrdiff_t cycle = row;
+        while (cycle >= 0 && out.depth[cycle] == UNPLACED) {
+            out.depth[cycle] = UNPLACED - 1; // On the path being followed
+            cycle = table.find(ppids[cycle]);
+        }
+        bool onCycle = cycle >= 0 && out.depth[cycle] == UNPLACED - 1;
+        for (ptrdiff_t path = row; path >= 0 && out.depth[path] == UNPLACED - 1;) {
+            out.depth[path] = UNPLACED;
+            path = table.find(ppids[path]);
+        }
+        walk(onCycle ? static_cast<uint32_t>(cycle) : row);
+    }
+
+    for (size_t i = rows; i-- > 0;) {
+        uint32_t row = out.preorder[i];
+        int32_t parent = out.parentRow[row];
+        if (parent >= 0) {
+            out.subtreeSize[parent] += out.subtreeSize[row];
+            out.subtreeCpu[parent] += out.subtreeCpu[row];
+            out.subtreeMem[parent] += out.subtreeMem[row];
+        }
+    }
+}
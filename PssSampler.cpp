@@ -0,0 +1,87 @@
+#include "header.h"
+
+// Age given to processes without a value yet, so they are read before any value is refreshed
+static constexpr double kUnreadAgeSeconds = 24 * 60 * 60;
+
+/**
+ * Replaces the processes read first in every pass (the ones selected in the UI)
+ *
+ * @param pids Processes to prioritize
+ */
+void PssSampler::prioritize(const std::vector<int>& pids) {
+    std::lock_guard<std::mutex> lock(priorityMutex);
+    priorityPids.clear();
+    priorityPids.insert(pids.begin(), pids.end());
+}
+
+/**
+ * Reads smaps_rollup for as many processes as the budget allows, then fills
+ * the PSS/USS values of every process from the latest read
+ * Processes without an address space (kernel threads, zombies) have an RSS of
+ * 0 and are never read.
+ *
+ * @param processes Latest sample of every process; their pss member is filled
+ * @param budget Wall time the reads may take; the first read always happens
+ * @param pass Receives the number of reads and the time they took
+ */
+void PssSampler::sample(std::vector<ProcessInfo>& processes, std::chrono::microseconds budget,
+                        ScanPassStats& pass) {
+    const auto now = std::chrono::steady_clock::now();
+
+    candidates.clear();
+    {
+        std::lock_guard<std::mutex> lock(priorityMutex);
+        for (size_t i = 0; i < processes.size(); i++) {
+            const ProcessInfo& process = processes[i];
+            if (!process.isActive || process.memory.rssKb <= 0) {
+                continue;
+            }
+            if (priorityPids.count(process.pid) > 0) {
+                candidates.emplace_back(std::numeric_limits<double>::infinity(), i);
+                continue;
+            }
+            auto it = entries.find(process.pid);
+            double age = it != entries.end() && it->second.startTime == process.startTime
+                ? std::chrono::duration<double>(now - it->second.pss.sampledAt).count()
+                : kUnreadAgeSeconds;
+            candidates.emplace_back(static_cast<double>(process.memory.rssKb) * age, i);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), std::greater<>());
+
+    for (const auto& candidate : candidates) {
+        auto elapsed = std::chrono::steady_clock::now() - now;
+        if (pass.pssRead > 0 && elapsed >= budget) {
+            break; // The rest keep their earlier values and move up by age
+        }
+        const ProcessInfo& process = processes[candidate.second];
+        Entry& entry = entries[process.pid];
+        entry.startTime = process.startTime;
+        if (!GetProcessPss(process.pid, entry.pss)) {
+            // Unreadable (no ptrace access, exited or quarantined): n/a, retried once its turn comes again
+            entry.pss = ProcessPss{};
+            entry.pss.sampledAt = std::chrono::steady_clock::now();
+        }
+        pass.pssRead++;
+    }
+    pass.pssTime = std::chrono::steady_clock::now() - now;
+
+    for (ProcessInfo& process : processes) {
+        auto it = entries.find(process.pid);
+        if (it != entries.end() && it->second.startTime == process.startTime) {
+            process.pss = it->second.pss;
+        }
+    }
+}
+
+/**
+ * Drops the stored values of a process that has exited
+ *
+ * @param pid Process ID to forget
+ */
+void PssSampler::forget(int pid) {
+    entries.erase(pid);
+}
+
+// Define the global sampler; sample() and forget() run on the collector thread
+PssSampler g_pssSampler;
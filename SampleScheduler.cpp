@@ -0,0 +1,109 @@
+#include "header.h"
+
+/**
+ * Creates a scheduler
+ *
+ * @param maxIntervalCycles Longest wait between two samples of an idle process
+ */
+SampleScheduler::SampleScheduler(unsigned maxIntervalCycles) : maxInterval(std::max(1u, maxIntervalCycles)) {}
+
+/**
+ * Starts the next cycle and lists the PIDs to sample in it
+ *
+ * @param pids Every live PID of this cycle
+ * @param due Receives the PIDs whose timer fired, that were woken or that are new
+ */
+void SampleScheduler::advance(const std::vector<int>& pids, std::vector<int>& due) {
+    wheel.advance(expired);
+    unsigned long long tick = wheel.now();
+    due.clear();
+
+    // A timer is stale if the PID was forgotten or rescheduled since
+    for (int pid : expired) {
+        auto it = entries.find(pid);
+        if (it != entries.end() && it->second.due == tick) {
+            due.push_back(pid);
+        }
+    }
+
+    for (int pid : woken) {
+        auto it = entries.find(pid);
+        if (it != entries.end() && it->second.due != tick) {
+            it->second.due = tick;
+            due.push_back(pid);
+        }
+    }
+    woken.clear();
+
+    for (int pid : pids) {
+        if (entries.find(pid) == entries.end()) {
+            entries.emplace(pid, Entry{tick, 1, ProcessInfo{}});
+            due.push_back(pid);
+        }
+    }
+}
+
+/**
+ * Stores a fresh sample and schedules the next one
+ *
+ * @param pid Process ID
+ * @param sample Result of FetchProcessInfo(); inactive if the process is gone
+ */
+void SampleScheduler::record(int pid, ProcessInfo&& sample) {
+    auto it = entries.find(pid);
+    if (it == entries.end()) {
+        return;
+    }
+    if (!sample.isActive) {
+        entries.erase(it);
+        return;
+    }
+
+    Entry& entry = it->second;
+    // Any CPU usage means utime/stime moved since the previous sample; disk I/O
+    // counts too, as a process waiting on the disk can use next to no CPU
+    bool changed = !entry.last.isActive || sample.cpuUsage > 0.0f ||
+                   sample.memory.rssKb != entry.last.memory.rssKb ||
+                   sample.memory.swapKb != entry.last.memory.swapKb || sample.state != entry.last.state ||
+                   sample.startTime != entry.last.startTime || sample.readBytesPerSec > 0.0f ||
+                   sample.writeBytesPerSec > 0.0f;
+    entry.interval = changed ? 1 : std::min(entry.interval * 2, maxInterval);
+    entry.last = std::move(sample);
+    entry.due = wheel.now() + entry.interval;
+    wheel.schedule(pid, entry.due);
+}
+
+/**
+ * Samples a process on the next cycle regardless of its interval (e.g. after exec)
+ *
+ * @param pid Process ID
+ */
+void SampleScheduler::wake(int pid) {
+    woken.push_back(pid);
+}
+
+/**
+ * Drops a process that has exited
+ *
+ * @param pid Process ID
+ */
+void SampleScheduler::forget(int pid) {
+    entries.erase(pid);
+}
+
+/**
+ * Gathers the latest sample of each PID, whether or not it was sampled this cycle
+ *
+ * @param pids Every live PID of this cycle
+ * @param latest Cleared, then receives one entry per PID that has been sampled
+ */
+void SampleScheduler::collect(const std::vector<int>& pids, std::vector<ProcessInfo>& latest) const {
+    latest.clear();
+    latest.reserve(pids.size());
+    for (int pid : pids) {
+        auto it = entries.find(pid);
+        if (it != entries.end() && it->second.last.isActive) {
+            latest.push_back(it->second.last);
+        }
+    }
+}
@@ -0,0 +1,49 @@
+#include "header.h"
+
+/**
+ * Starts a new pass by sharding its PIDs over the slices of the interval
+ * Work still carried from the previous pass is dropped; its PIDs are due again.
+ *
+ * @param pids PIDs to read during the pass
+ * @param slices Number of slices the interval is split into (at least 1)
+ */
+void ScanSlicer::plan(const std::vector<int>& pids, unsigned slices) {
+    slices = std::max(1u, slices);
+    // Keep the inner vectors' capacity; shards only grow to the largest slice seen
+    for (std::vector<size_t>& shard : shards) {
+        shard.clear();
+    }
+    shards.resize(slices);
+    for (size_t i = 0; i < pids.size(); i++) {
+        shards[static_cast<unsigned>(pids[i]) % slices].push_back(i);
+    }
+    current.clear();
+    nextShard = 0;
+    deferredCount = 0;
+}
+
+/**
+ * Returns the work of the next slice: whatever earlier slices carried over,
+ * followed by this slice's own shard
+ * Once the planned slices are used up only carried work remains.
+ *
+ * @return Indexes into the PID list given to plan(); valid until finishSlice()
+ */
+const std::vector<size_t>& ScanSlicer::nextSlice() {
+    if (nextShard < shards.size()) {
+        const std::vector<size_t>& shard = shards[nextShard++];
+        current.insert(current.end(), shard.begin(), shard.end());
+    }
+    return current;
+}
+
+/**
+ * Ends the current slice, carrying its unprocessed work over to the next one
+ *
+ * @param processed Number of leading entries of nextSlice() that were done
+ */
+void ScanSlicer::finishSlice(size_t processed) {
+    processed = std::min(processed, current.size());
+    current.erase(current.begin(), current.begin() + processed);
+    deferredCount += current.size();
+}
@@ -0,0 +1,96 @@
+#include "header.h"
+
+/**
+ * Creates a pool with a fixed number of worker threads
+ * Workers live for the lifetime of the pool, so the thread count stays
+ * constant no matter how many tasks are submitted
+ *
+ * @param threadCount Number of workers to start (at least one is always started)
+ */
+ThreadPool::ThreadPool(size_t threadCount) {
+    threadCount = std::max<size_t>(1, threadCount);
+    workers.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; i++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+/**
+ * Stops the pool and joins all workers
+ * Tasks already queued are still run before the workers exit
+ */
+ThreadPool::~ThreadPool() {
+    shutdown();
+}
+
+/**
+ * Queues a task to be run by the next free worker
+ *
+ * @param task Callable to run on a worker thread
+ */
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stopping) {
+            return; // Pool is shutting down, drop late submissions
+        }
+        tasks.push(std::move(task));
+        unfinishedTasks++;
+    }
+    taskAvailable.notify_one();
+}
+
+/**
+ * Blocks until every submitted task has finished running
+ */
+void ThreadPool::waitIdle() {
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this]() { return unfinishedTasks == 0; });
+}
+
+/**
+ * Drains the queue and joins all workers
+ * Safe to call more than once
+ */
+void ThreadPool::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    taskAvailable.notify_all();
+
+    for (auto& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+/**
+ * Main loop of each worker thread
+ * Pops tasks until the pool is stopping and the queue is empty
+ */
+void ThreadPool::workerLoop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            taskAvailable.wait(lock, [this]() { return stopping || !tasks.empty(); });
+            if (tasks.empty()) {
+                return; // Stopping and nothing left to run
+            }
+            task = std::move(tasks.front());
+            tasks.pop();
+        }
+
+        try {
+            task();
+        } catch (...) { /* Silently ignore errors to prevent worker crashes */ }
+
+        // Signal waitIdle() once the last outstanding task completes
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--unfinishedTasks == 0) {
+            idle.notify_all();
+        }
+    }
+}
@@ -0,0 +1,72 @@
+#include "header.h"
+
+/**
+ * Schedules a timer
+ *
+ * @param id Caller-defined id returned when the timer expires
+ * @param due Tick at which the timer expires; past ticks expire on the next advance()
+ */
+void TimerWheel::schedule(int id, unsigned long long due) {
+    place(Timer{id, std::max(due, current + 1)});
+}
+
+/**
+ * Puts a timer in the lowest level whose span covers its distance from now
+ *
+ * @param timer Timer due after the current tick
+ */
+void TimerWheel::place(const Timer& timer) {
+    unsigned long long delta = timer.due - current;
+    unsigned level = 0;
+    while (level + 1 < LEVELS && delta >= (1ull << (SLOT_BITS * (level + 1)))) {
+        level++;
+    }
+
+    // Beyond the top level's span the timer waits in the furthest slot and is re-placed on cascade
+    unsigned long long maxDue = current + (1ull << (SLOT_BITS * LEVELS)) - 1;
+    unsigned long long due = std::min(timer.due, maxDue);
+    size_t slot = (due >> (SLOT_BITS * level)) & (SLOTS - 1);
+    levels[level][slot].push_back(timer);
+}
+
+/**
+ * Moves the timers of the current slot of a level down to lower levels
+ *
+ * @param level Level to cascade from (1 or above)
+ * @param expired Receives timers that are due now
+ */
+void TimerWheel::cascade(unsigned level, std::vector<int>& expired) {
+    size_t slot = (current >> (SLOT_BITS * level)) & (SLOTS - 1);
+    std::vector<Timer> timers;
+    timers.swap(levels[level][slot]);
+    for (const Timer& timer : timers) {
+        if (timer.due <= current) {
+            expired.push_back(timer.id);
+        } else {
+            place(timer);
+        }
+    }
+}
+
+/**
+ * Advances the wheel by one tick
+ *
+ * @param expired Cleared, then receives the ids of the timers due at the new tick
+ */
+void TimerWheel::advance(std::vector<int>& expired) {
+    expired.clear();
+    current++;
+
+    // Each time a level wraps, the next slot of the level above is spread over it
+    for (unsigned level = LEVELS - 1; level > 0; level--) {
+        if ((current & ((1ull << (SLOT_BITS * level)) - 1)) == 0) {
+            cascade(level, expired);
+        }
+    }
+
+    std::vector<Timer>& slot = levels[0][current & (SLOTS - 1)];
+    for (const Timer& timer : slot) {
+        expired.push_back(timer.id);
+    }
+    slot.clear();
+}
@@ -0,0 +1,142 @@
+#include "header.h"
+
+/**
+ * Brings the top-K rows up to date with the displayed snapshot
+ * A snapshot that directly follows the previous one is handled incrementally;
+ * a skipped generation, a new K or metric, or a top process reported exited
+ * since the last call recomputes from the whole table.
+ *
+ * @param latest Snapshot being displayed
+ * @param latestMetric ProcessColumn::Cpu or ProcessColumn::Memory
+ * @param latestK Number of processes to keep
+ * @param exited (pid, starttime) of the processes to leave out
+ * @return true if the rows changed
+ */
+bool TopConsumers::update(const std::shared_ptr<const ProcessSnapshot>& latest, ProcessColumn latestMetric,
+                          size_t latestK, const std::set<std::pair<int, unsigned long long>>& exited) {
+    if (latest == snapshot && latestMetric == metric && latestK == k) {
+        // Within one scan the exited set only grows; it matters once it hits a listed row
+        if (exited.size() == exitedSeen) {
+            return false;
+        }
+        exitedSeen = exited.size();
+        const ProcessTable& table = snapshot->table;
+        bool listedExited = std::any_of(top.begin(), top.end(), [&](uint32_t row) {
+            return exited.count({table.pids()[row], table.startTimes()[row]}) > 0;
+        });
+        if (listedExited) {
+            selectAll(exited);
+        }
+        return listedExited;
+    }
+
+    std::shared_ptr<const ProcessSnapshot> previous = std::move(snapshot);
+    bool sameSelection = latestMetric == metric && latestK == k;
+    snapshot = latest;
+    metric = latestMetric;
+    k = latestK;
+    exitedSeen = exited.size();
+
+    if (!snapshot || k == 0) {
+        top.clear();
+        skipped.clear();
+    } else if (!previous || !sameSelection || previous->generation + 1 != snapshot->generation ||
+               !selectIncremental(*previous, exited)) {
+        selectAll(exited);
+    }
+    return true;
+}
+
+/**
+ * Selects the top K from every row of the current snapshot (O(n log K))
+ *
+ * @param exited (pid, starttime) of the processes to leave out
+ */
+void TopConsumers::selectAll(const std::set<Identity>& exited) {
+    candidates.resize(snapshot->table.size());
+    for (uint32_t row = 0; row < candidates.size(); row++) {
+        candidates[row] = row;
+    }
+    selectTop(candidates, exited);
+}
+
+/**
+ * Derives the top K of the current snapshot from the previous one
+ * Rows are matched by PID and start time. Only the previous top K, the rows
+ * left out as exited and the rows this scan sampled are considered: every
+ * other row kept its value and already ranked below the previous K-th row.
+ * The result is therefore exact when its K-th row still ranks at or above
+ * that row; otherwise a row outside the candidates may belong in it.
+ *
+ * @param previous Snapshot directly preceding the current one
+ * @param exited (pid, starttime) of the processes to leave out
+ * @return false if the result could not be proven and must be recomputed
+ */
+bool TopConsumers::selectIncremental(const ProcessSnapshot& previous, const std::set<Identity>& exited) {
+    const ProcessTable& table = snapshot->table;
+    const ProcessTable& before = previous.table;
+
+    // Only a full top K bounds the rows outside it
+    bool bounded = top.size() == k;
+    float boundaryValue = bounded ? (metric == ProcessColumn::Memory ? before.mem() : before.cpu())[top.back()] : 0;
+    int boundaryPid = bounded ? before.pids()[top.back()] : 0;
+
+    candidates.clear();
+    for (const std::vector<uint32_t>* rows : {&top, &skipped}) {
+        for (uint32_t oldRow : *rows) {
+            ptrdiff_t row = table.find(before.pids()[oldRow]);
+            if (row >= 0 && table.startTimes()[row] == before.startTimes()[oldRow]) {
+                candidates.push_back(static_cast<uint32_t>(row));
+            }
+        }
+    }
+    candidates.insert(candidates.end(), snapshot->sampledRows.begin(), snapshot->sampledRows.end());
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    selectTop(candidates, exited);
+    if (!bounded) {
+        return true; // Every row was a candidate
+    }
+    if (top.size() < k) {
+        return false;
+    }
+    float lowestValue = (metric == ProcessColumn::Memory ? table.mem() : table.cpu())[top.back()];
+    int lowestPid = table.pids()[top.back()];
+    return lowestValue > boundaryValue || (lowestValue == boundaryValue && lowestPid <= boundaryPid);
+}
+
+/**
+ * Keeps the K highest of the given rows, highest first, and records the
+ * exited ones passed over
+ *
+ * @param rows Rows of the current snapshot to choose from
+ * @param exited (pid, starttime) of the processes to leave out
+ */
+void TopConsumers::selectTop(const std::vector<uint32_t>& rows, const std::set<Identity>& exited) {
+    const ProcessTable& table = snapshot->table;
+    const std::vector<float>& values = metric == ProcessColumn::Memory ? table.mem() : table.cpu();
+    const std::vector<int>& pids = table.pids();
+    auto higher = [&](uint32_t a, uint32_t b) {
+        return values[a] > values[b] || (values[a] == values[b] && pids[a] < pids[b]);
+    };
+
+    // Heap ordered by `higher` keeps the lowest of the current top K at the front,
+    // so most rows are rejected with a single comparison
+    top.clear();
+    skipped.clear();
+    top.reserve(k);
+    for (uint32_t row : rows) {
+        if (!exited.empty() && exited.count({pids[row], table.startTimes()[row]}) > 0) {
+            skipped.push_back(row);
+        } else if (top.size() < k) {
+            top.push_back(row);
+            std::push_heap(top.begin(), top.end(), higher);
+        } else if (higher(row, top.front())) {
+            std::pop_heap(top.begin(), top.end(), higher);
+            top.back() = row;
+            std::push_heap(top.begin(), top.end(), higher);
+        }
+    }
+    std::sort_heap(top.begin(), top.end(), higher);
+}
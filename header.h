@@ -33,6 +33,16 @@
 #include <chrono>                                  // Time utilities
 #include <thread>                                  // Threading support
 #include <future>                                  // Asynchronous computations
+#include <mutex>                                   // Mutual exclusion
+#include <condition_variable>                      // Thread signalling
+#include <atomic>                                  // Atomic operations
+#include <functional>                              // Function wrappers
+#include <string_view>                             // Non-owning string views
+#include <list>                                    // Doubly linked lists
+#include <unordered_set>                           // Hash sets
+#include <cstdint>                                 // Fixed-width integer types
+#include <set>                                     // Ordered sets
+#include <regex>                                   // Regular expressions
 
 //------------------------------------------------------------------------------
 // System Headers                                   // Linux system functionality
@@ -62,19 +72,112 @@ struct CPUStats {
 };
 
 // Process Statistics Structure
+// One sample of a process's CPU times, kept between scan cycles for delta accounting
 struct ProcessStats {
+    unsigned long long startTime;     // Samples of a different starttime belong to another process
     unsigned long long utime, stime, cutime, cstime;
+    unsigned long long systemTicks;   // SystemSnapshot::totalCpuTicks when sampled
+    std::chrono::steady_clock::time_point sampleTime;
 };
 
+// Process I/O Statistics Structure
+// One sample of /proc/<pid>/io, kept between scan cycles like ProcessStats
+struct ProcessIoStats {
+    unsigned long long startTime;
+    unsigned long long readBytes, writeBytes;   // Storage I/O (read_bytes, write_bytes)
+    unsigned long long syscalls;                // Read and write syscalls (syscr + syscw)
+    std::chrono::steady_clock::time_point sampleTime;
+};
+
+// Parsed /proc/<pid>/stat Structure
+// Only the fields the collector uses; comm points into the buffer that was parsed
+struct ProcStat {
+    std::string_view comm;
+    char state;
+    int ppid;
+    unsigned long long utime, stime, cutime, cstime;
+    long numThreads;
+    unsigned long long startTime;   // Clock ticks after boot
+    long rssPages;
+};
+
+// Buffer size that comfortably fits any /proc/<pid>/stat line
+constexpr size_t PROC_STAT_BUFFER_SIZE = 1024;
+
+// Memory of one process in kB, from /proc/<pid>/status or the cheaper statm.
+// statm only has the resident total, so the breakdown stays negative (n/a)
+// unless status was read; kernel threads have no memory and read as 0.
+struct ProcessMemory {
+    long long rssKb = -1;
+    long long anonKb = -1;      // RssAnon
+    long long fileKb = -1;      // RssFile
+    long long shmemKb = -1;     // RssShmem
+    long long swapKb = -1;      // VmSwap
+    long threads = -1;
+};
+
+// Buffer size that fits /proc/<pid>/status, the larger of the two memory files
+constexpr size_t PROC_STATUS_BUFFER_SIZE = 4096;
+
+// Most bytes of /proc/<pid>/cmdline kept per process
+constexpr size_t PROC_CMDLINE_BUFFER_SIZE = 4096;
+
+// Proportional and unique set size in kB, from /proc/<pid>/smaps_rollup. PSS
+// splits each shared page between the processes mapping it; USS counts only
+// private pages. Negative until the process was read (or when it may not be).
+struct ProcessPss {
+    long long pssKb = -1;
+    long long ussKb = -1;
+    std::chrono::steady_clock::time_point sampledAt{};  // When the values were read; epoch if never
+};
+
+// System Snapshot Structure
+// Global values captured once per scan and shared by every per-process computation
+struct SystemSnapshot {
+    CPUStats cpu;
+    unsigned long long totalCpuTicks;  // Sum of all CPUStats fields, 0 if /proc/stat was unreadable
+    long clockTicksPerSecond;
+    long numCores;
+    long pageSize;
+    unsigned long long totalMemoryKb;
+    std::chrono::steady_clock::time_point takenAt;
+};
+
+// Scheduler state of a process (the state letter of /proc/<pid>/stat)
+enum class ProcState : uint8_t {
+    Running,        // R
+    Sleeping,       // S
+    DiskSleep,      // D
+    Zombie,         // Z
+    Stopped,        // T
+    TracingStop,    // t
+    Dead,           // X
+    Idle,           // I
+    Unknown
+};
+
+ProcState ProcStateFromChar(char state);
+const char* ProcStateLabel(ProcState state);
+
+struct ProcessIdentity;
+
 // Process Information Structure
 struct ProcessInfo {
     int pid;
+    int ppid;                       // Parent process ID, 0 for init and kthreadd
+    unsigned long long startTime;   // With pid, identifies the process across PID reuse
     std::string name;
-    std::string state;
+    ProcState state;
     float cpuUsage;
     float memoryUsage;
+    ProcessMemory memory;
+    ProcessPss pss;                 // Filled by g_pssSampler for the processes it has read
+    float readBytesPerSec;          // Disk I/O rates; negative when not collected or not readable
+    float writeBytesPerSec;
+    float ioSyscallsPerSec;
     std::chrono::steady_clock::time_point lastCpuUpdateTime;
     bool isActive;
+    std::shared_ptr<const ProcessIdentity> identity;  // Shared per process, holds the command line
 };
 
 // Network Interface Structure
@@ -109,8 +212,13 @@ void GetDiskUsage(float &diskUsedPercentage, std::string &usedStorageStr, std::s
 //------------------------------------------------------------------------------
 // Process & Memory Management Functions
 //------------------------------------------------------------------------------
-float GetCPUUsage(int pid);
-float GetMemUsage(int pid);
+SystemSnapshot CaptureSystemSnapshot();
+float GetCPUUsage(int pid, const ProcStat &stat, const SystemSnapshot &snapshot);
+bool GetProcessMemory(int pid, bool detail, const SystemSnapshot &snapshot, ProcessMemory &memory);
+bool GetProcessPss(int pid, ProcessPss &pss);
+void GetIoUsage(int pid, unsigned long long startTime, ProcessInfo &process);
+struct ProcPreread;
+ProcessInfo FetchProcessInfo(int pid, const SystemSnapshot &snapshot, const ProcPreread *preread = nullptr);
 std::vector<ProcessInfo> FetchProcessList();
 void RenderProcessMonitorUI();
 std::pair<std::pair<std::pair<long, std::string>, std::pair<long, std::string>>,
@@ -120,12 +228,33 @@ std::pair<std::pair<long, long>, std::pair<std::string, std::string>> getDiskUsa
 bool isNumber(const std::string &str);
 std::vector<int> GetAllPIDs();
 
+//------------------------------------------------------------------------------
+// /proc Parsing Functions
+//------------------------------------------------------------------------------
+extern std::atomic<unsigned long long> g_procSyscalls;
+inline void CountProcSyscalls(unsigned long long count = 1) {
+    g_procSyscalls.fetch_add(count, std::memory_order_relaxed);
+}
+bool ParseProcStat(std::string_view line, ProcStat &out);
+bool ReadProcStat(int pid, char *buffer, size_t capacity, ProcStat &out);
+bool IsProcessAlive(int pid);
+bool ParseProcStatus(std::string_view status, ProcessMemory &out);
+bool ParseProcStatm(std::string_view statm, long pageSize, ProcessMemory &out);
+bool ParseSmapsRollup(std::string_view rollup, ProcessPss &out);
+
 //------------------------------------------------------------------------------
 // Network Functions
 //------------------------------------------------------------------------------
 std::vector<NetworkInterface> getNetworkInfo();
 std::string formatBytes(long long bytes);
 void StartFetchingProcesses();
+void StopFetchingProcesses();
+extern std::atomic<bool> g_useIoUring;
+extern std::atomic<bool> g_ioUringActive;
+extern std::atomic<bool> g_collectIo;
+extern std::atomic<bool> g_collectMemoryDetail;
+extern std::atomic<bool> g_collectPss;
+extern std::atomic<int> g_pssBudgetUs;
 void RenderNetworkTable(const char* label, const std::vector<NetworkInterface>& interfaces, bool isRX);
 
 //------------------------------------------------------------------------------
@@ -135,16 +264,908 @@ class ProcessInfoQueue {
 private:
     std::queue<ProcessInfo> queue;
     std::mutex mutex;
-    std::condition_variable cond;
 
 public:
     void push(ProcessInfo&& item);
     bool try_pop(ProcessInfo& item);
 };
 
-extern ProcessInfoQueue g_completedProcesses;
+extern ProcessInfoQueue g_exitedProcesses;   // Exit notifications from the proc connector
+
+//------------------------------------------------------------------------------
+// Adaptive Sampling
+//------------------------------------------------------------------------------
+// Hierarchical timer wheel counting collector cycles. Three levels of 64
+// slots cover 64, 4096 and 262144 ticks; timers further out wait in the
+// top level and are re-placed each time it cascades.
+// Scheduling and expiring are O(1) per timer, plus one cascade per timer
+// per level it descends. Timers cannot be cancelled; owners ignore stale ones.
+class TimerWheel {
+private:
+    static constexpr unsigned SLOT_BITS = 6;
+    static constexpr unsigned SLOTS = 1u << SLOT_BITS;
+    static constexpr unsigned LEVELS = 3;
+
+    struct Timer {
+        int id;
+        unsigned long long due;
+    };
+
+    std::array<std::array<std::vector<Timer>, SLOTS>, LEVELS> levels;
+    unsigned long long current = 0;
+
+    void place(const Timer& timer);
+    void cascade(unsigned level, std::vector<int>& expired);
+
+public:
+    void schedule(int id, unsigned long long due);
+    void advance(std::vector<int>& expired);
+    unsigned long long now() const { return current; }
+};
+
+// Decides which PIDs are sampled each collector cycle. A process whose CPU
+// time, RSS or state changed since its last sample is sampled again next
+// cycle; an unchanged one waits twice as long each time, up to a cap.
+// New and exec'd processes are sampled immediately. The latest sample of
+// every process is kept so skipped processes still appear in snapshots.
+class SampleScheduler {
+private:
+    struct Entry {
+        unsigned long long due;     // Cycle of the next sample
+        unsigned interval;          // Cycles between samples
+        ProcessInfo last;           // Latest sample (inactive until the first one)
+    };
+
+    TimerWheel wheel;
+    std::unordered_map<int, Entry> entries;
+    std::vector<int> expired;
+    std::vector<int> woken;
+    unsigned maxInterval;
+
+public:
+    explicit SampleScheduler(unsigned maxIntervalCycles);
+
+    void advance(const std::vector<int>& pids, std::vector<int>& due);
+    void record(int pid, ProcessInfo&& sample);
+    void wake(int pid);
+    void forget(int pid);
+    void collect(const std::vector<int>& pids, std::vector<ProcessInfo>& latest) const;
+};
+
+//------------------------------------------------------------------------------
+// Time-Sliced Scanning
+//------------------------------------------------------------------------------
+// Start-to-start period of a full scan pass
+constexpr std::chrono::milliseconds PROC_SCAN_INTERVAL(2000);
+constexpr int PROC_SCAN_MAX_SLICES = 50;
+
+// Slices per pass and the worker CPU time each slice may spend, in
+// microseconds (0 = unlimited); set from the UI
+extern std::atomic<int> g_scanSlices;
+extern std::atomic<int> g_sliceCpuBudgetUs;
+
+// How the last scan pass went
+struct ScanPassStats {
+    unsigned plannedSlices = 0;                      // Slices the interval was split into
+    unsigned slicesRun = 0;                          // More than planned when work spilled past the interval
+    size_t sampled = 0;                              // PIDs read during the pass
+    size_t deferred = 0;                             // Times the CPU budget pushed a read to a later slice
+    std::chrono::nanoseconds cpuTime{};              // CPU time spent reading /proc
+    std::chrono::nanoseconds maxSliceCpuTime{};      // Most expensive slice
+    std::chrono::steady_clock::duration wallTime{};  // Pass start to end of its last slice
+    bool overran = false;                            // Pass did not finish inside its interval
+    unsigned long long overruns = 0;                 // Overrunning passes since the collector started
+    size_t pssRead = 0;                              // smaps_rollup files read after the pass
+    std::chrono::steady_clock::duration pssTime{};   // Time those reads took
+};
+
+// Spreads the PIDs of one pass over the slices of the scan interval. PIDs are
+// sharded by pid % slices, so a process is read at the same offset in every
+// pass and its CPU deltas span a whole interval. Work a slice leaves undone
+// is carried over, ahead of the next slice's own shard.
+class ScanSlicer {
+private:
+    std::vector<std::vector<size_t>> shards;  // Indexes into the pass's PID list, per slice
+    std::vector<size_t> current;              // Carried work followed by this slice's shard
+    size_t nextShard = 0;
+    size_t deferredCount = 0;
+
+public:
+    void plan(const std::vector<int>& pids, unsigned slices);
+    const std::vector<size_t>& nextSlice();
+    void finishSlice(size_t processed);
+    bool pending() const { return !current.empty() || nextShard < shards.size(); }
+    size_t deferred() const { return deferredCount; }
+};
+
+//------------------------------------------------------------------------------
+// Columnar Process Store
+//------------------------------------------------------------------------------
+// Maps process names to small stable ids so a name is stored once however
+// many processes share it. Ids are never reused; the set of distinct
+// executable names on a host is small.
+class NameInterner {
+private:
+    std::unordered_map<std::string, uint32_t> ids;
+    std::vector<std::string> names;
+
+public:
+    uint32_t intern(const std::string& name);
+    bool contains(const std::string& name) const { return ids.count(name) > 0; }
+    const std::string& name(uint32_t id) const { return names[id]; }
+    size_t size() const { return names.size(); }
+};
+
+// Structure-of-arrays table of processes: one dense column per field, so
+// sorting and filtering scan contiguous memory. A PID -> row index makes
+// lookups O(1). Name ids refer to an interner shared with other tables.
+class ProcessTable {
+private:
+    std::unordered_map<int, uint32_t> rowOfPid;
+    std::vector<int> pidColumn;
+    std::vector<int> ppidColumn;
+    std::vector<unsigned long long> startTimeColumn;
+    std::vector<uint32_t> nameIdColumn;
+    std::vector<ProcState> stateColumn;
+    std::vector<float> cpuColumn;
+    std::vector<float> memColumn;
+    std::vector<float> ioReadColumn;
+    std::vector<float> ioWriteColumn;
+    std::vector<float> ioSyscallColumn;
+    std::vector<long long> rssColumn;       // kB; the breakdown columns are negative when not read
+    std::vector<long long> rssAnonColumn;
+    std::vector<long long> rssFileColumn;
+    std::vector<long long> rssShmemColumn;
+    std::vector<long long> swapColumn;
+    std::vector<long> threadColumn;
+    std::vector<long long> pssColumn;       // kB, negative when never read
+    std::vector<long long> ussColumn;
+    std::vector<std::chrono::steady_clock::time_point> pssSampledAtColumn;
+    std::vector<std::shared_ptr<const ProcessIdentity>> identityColumn;
+    std::shared_ptr<const NameInterner> names;
+
+public:
+    explicit ProcessTable(std::shared_ptr<const NameInterner> names);
+
+    size_t size() const { return pidColumn.size(); }
+    bool empty() const { return pidColumn.empty(); }
+
+    void reserve(size_t rows);
+    ptrdiff_t find(int pid) const;
+    void append(const ProcessInfo& process, uint32_t nameId);
+    size_t memoryBytes() const;
+
+    const std::vector<int>& pids() const { return pidColumn; }
+    const std::vector<int>& ppids() const { return ppidColumn; }
+    const std::vector<unsigned long long>& startTimes() const { return startTimeColumn; }
+    const std::vector<uint32_t>& nameIds() const { return nameIdColumn; }
+    const std::vector<ProcState>& states() const { return stateColumn; }
+    const std::vector<float>& cpu() const { return cpuColumn; }
+    const std::vector<float>& mem() const { return memColumn; }
+    const std::vector<float>& ioRead() const { return ioReadColumn; }
+    const std::vector<float>& ioWrite() const { return ioWriteColumn; }
+    const std::vector<float>& ioSyscalls() const { return ioSyscallColumn; }
+    const std::vector<long long>& rss() const { return rssColumn; }
+    const std::vector<long long>& rssAnon() const { return rssAnonColumn; }
+    const std::vector<long long>& rssFile() const { return rssFileColumn; }
+    const std::vector<long long>& rssShmem() const { return rssShmemColumn; }
+    const std::vector<long long>& swap() const { return swapColumn; }
+    const std::vector<long>& threads() const { return threadColumn; }
+    const std::vector<long long>& pss() const { return pssColumn; }
+    const std::vector<long long>& uss() const { return ussColumn; }
+    const std::vector<std::chrono::steady_clock::time_point>& pssSampledAt() const { return pssSampledAtColumn; }
+    const std::string& name(size_t row) const { return names->name(nameIdColumn[row]); }
+    const std::string& cmdline(size_t row) const;
+    size_t nameCount() const { return names->size(); }
+};
+
+// Parent/child layout of the rows of one snapshot. preorder lists the rows
+// depth-first with children by ascending PID, so every subtree is one
+// contiguous run: preorder[i] is followed by its subtreeSize - 1 descendants.
+// The other columns are indexed by row.
+struct ProcessTreeLayout {
+    std::vector<uint32_t> preorder;
+    std::vector<int32_t> parentRow;      // -1 for roots
+    std::vector<uint32_t> depth;
+    std::vector<uint32_t> subtreeSize;   // Rows in the subtree, its root included
+    std::vector<float> subtreeCpu;       // CPU usage of the subtree, its root included
+    std::vector<float> subtreeMem;
+};
+
+// Parent -> children index over PIDs, kept by the collector across scans. It
+// is updated per sample and per exited PID instead of being rebuilt, and
+// lays out each snapshot's rows in one linear pass.
+class ProcessTree {
+private:
+    struct Node {
+        int parent = -1;             // -1 until the PID itself is sampled
+        std::vector<int> children;   // Ascending
+    };
+
+    std::unordered_map<int, Node> nodes;
+    std::vector<std::pair<uint32_t, uint32_t>> stack;  // Layout scratch: (row, depth)
+
+    void unlink(int pid, int parent);
+
+public:
+    void update(int pid, int ppid);
+    void remove(int pid, std::vector<int>& orphans);
+    void layout(const ProcessTable& table, ProcessTreeLayout& out);
+    size_t size() const { return nodes.size(); }
+};
+
+// Result of one complete collector scan. Published whole and never modified
+// afterwards, so readers need no lock and never see a half-updated table.
+struct ProcessSnapshot {
+    unsigned long long generation;                  // Collector scan number
+    std::chrono::steady_clock::time_point takenAt;  // When the scan started
+    ProcessTable table;
+    ScanPassStats pass;                             // Cost and timing of the scan
+    ProcessTreeLayout tree;                         // Parent/child layout of table's rows
+    std::vector<uint32_t> sampledRows;              // Rows read during this scan; the others repeat
+                                                    // their values from the previous generation
+};
+
+std::shared_ptr<const ProcessSnapshot> LatestProcessSnapshot();
+
+//------------------------------------------------------------------------------
+// Per-Process CPU Accounting
+//------------------------------------------------------------------------------
+class CPUUsageCalculator {
+private:
+    std::unordered_map<int, ProcessStats> previousSamples;
+    std::mutex mutex;
+
+public:
+    float update(int pid, const ProcessStats& current, const SystemSnapshot& snapshot);
+    void forget(int pid);
+};
+
+extern CPUUsageCalculator g_cpuUsageCalculator;
+
+//------------------------------------------------------------------------------
+// Per-Process I/O Accounting
+//------------------------------------------------------------------------------
+struct IoRates {
+    float readBytesPerSec;
+    float writeBytesPerSec;
+    float syscallsPerSec;
+};
+
+class IoUsageCalculator {
+private:
+    std::unordered_map<int, ProcessIoStats> previousSamples;
+    std::unordered_map<int, unsigned long long> deniedProcesses;   // pid -> starttime of processes we may not read
+    std::mutex mutex;
+
+public:
+    IoRates update(int pid, const ProcessIoStats& current);
+    bool denied(int pid, unsigned long long startTime);
+    void deny(int pid, unsigned long long startTime);
+    void forget(int pid);
+};
+
+extern IoUsageCalculator g_ioUsageCalculator;
+
+//------------------------------------------------------------------------------
+// PSS/USS Sampling
+//------------------------------------------------------------------------------
+// Reads /proc/<pid>/smaps_rollup for a rotating subset of processes. The
+// kernel walks every mapping of the process under its mm lock to produce the
+// file, so a large process costs milliseconds; each pass reads processes in
+// priority order until its time budget is spent and the rest keep the value
+// from an earlier pass. Processes picked in the UI come first, then the rest
+// by resident size times the age of their value, so large processes are
+// refreshed more often but every process is eventually reached.
+class PssSampler {
+private:
+    struct Entry {
+        unsigned long long startTime;
+        ProcessPss pss;
+    };
+
+    std::unordered_map<int, Entry> entries;             // Collector thread only
+    std::vector<std::pair<double, size_t>> candidates;  // Scratch: (priority, index into the processes)
+    std::unordered_set<int> priorityPids;               // Set from the UI thread
+    std::mutex priorityMutex;
+
+public:
+    void prioritize(const std::vector<int>& pids);
+    void sample(std::vector<ProcessInfo>& processes, std::chrono::microseconds budget, ScanPassStats& pass);
+    void forget(int pid);
+};
+
+extern PssSampler g_pssSampler;
+
+//------------------------------------------------------------------------------
+// Per-PID File Descriptor Cache
+//------------------------------------------------------------------------------
+enum class ProcFile { Stat, Status, Statm, Cmdline, Io, SmapsRollup, Count };
+
+class ProcFdCache {
+private:
+    // Descriptor shared with in-flight readers so eviction never closes it mid-read
+    struct CachedFd {
+        int fd;
+        explicit CachedFd(int fd) : fd(fd) {}
+        ~CachedFd();
+    };
+
+    struct Entry {
+        std::array<std::shared_ptr<CachedFd>, static_cast<size_t>(ProcFile::Count)> fds;
+        std::list<int>::iterator lruPosition;
+    };
+
+    int procDirFd = -1;
+    size_t fdBudget = 0;
+    size_t openFds = 0;
+    std::unordered_map<int, Entry> entries;
+    std::list<int> lruOrder;   // Most recently used PID first
+    std::mutex mutex;
+
+    std::shared_ptr<CachedFd> acquire(int pid, ProcFile file);
+    void eraseLocked(int pid);
+
+public:
+    ProcFdCache();
+    ~ProcFdCache();
+
+    ProcFdCache(const ProcFdCache&) = delete;
+    ProcFdCache& operator=(const ProcFdCache&) = delete;
+
+    ssize_t read(int pid, ProcFile file, char* buffer, size_t capacity);
+    ssize_t readOnce(int pid, ProcFile file, char* buffer, size_t capacity);
+    void forget(int pid);
+};
+
+extern ProcFdCache g_procFdCache;
+
+//------------------------------------------------------------------------------
+// Deadline-Bounded /proc Reads
+//------------------------------------------------------------------------------
+// Reading cmdline or status can block while the target's mm lock is held
+// (e.g. a process stuck in D state), so those reads run on reader threads
+// and callers stop waiting after a deadline.
+constexpr std::chrono::milliseconds PROC_READ_DEADLINE(250);
+
+class DeadlineReader {
+private:
+    // Reused by its calling thread until a read of it is abandoned
+    struct Request {
+        int pid;
+        ProcFile file;
+        bool cached;
+        size_t capacity = 0;
+        std::vector<char> data;     // Owned by the request so a late read never touches the caller
+        ssize_t length = -1;
+        bool started = false;
+        bool done = false;
+        bool abandoned = false;
+        std::condition_variable completed;
+    };
+
+    // Shared with the detached readers, which may outlive the DeadlineReader while blocked
+    struct State {
+        std::mutex mutex;
+        std::condition_variable requestAvailable;
+        std::queue<std::shared_ptr<Request>> requests;
+        size_t readers = 0;
+        size_t stuckReaders = 0;
+        size_t targetReaders = 0;
+        bool stopping = false;
+        std::unordered_map<int, std::chrono::steady_clock::time_point> quarantine;  // pid -> release time
+        std::unordered_map<int, const Request*> hungPids;   // PID -> its read still blocked in the kernel
+    };
+
+    std::shared_ptr<State> state;
+    std::chrono::milliseconds deadline;
+
+    void spawnReaderLocked();
+    bool isQuarantinedLocked(int pid);
+    static void readerLoop(std::shared_ptr<State> state);
+
+public:
+    DeadlineReader(size_t readerCount, std::chrono::milliseconds deadline);
+    ~DeadlineReader();
+
+    DeadlineReader(const DeadlineReader&) = delete;
+    DeadlineReader& operator=(const DeadlineReader&) = delete;
+
+    // Returned by read() when the outcome is unknown, as opposed to -1 for a failed read
+    static constexpr ssize_t TIMED_OUT = -2;
+
+    ssize_t read(int pid, ProcFile file, bool cached, size_t capacity, const char*& data);
+    bool isQuarantined(int pid);
+    void quarantine(int pid);
+    size_t quarantinedCount();
+    void forget(int pid);
+};
+
+extern DeadlineReader g_deadlineReader;
+
+//------------------------------------------------------------------------------
+// Batched /proc Reads (io_uring)
+//------------------------------------------------------------------------------
+// Per-cycle files of one PID read ahead of FetchProcessInfo(); empty if not read
+struct ProcPreread {
+    std::string_view stat;
+    std::string_view status;    // Only one of status and statm is read, see ProcReadBatch::memoryFile
+    std::string_view statm;
+};
+
+// Buffers of one batched read; kept alive until the kernel is done with them
+struct ProcReadBatch {
+    static constexpr size_t PATH_SIZE = 32;
+
+    uint32_t generation = 0;
+    ProcFile memoryFile = ProcFile::Statm;  // Status when the memory breakdown is collected
+    std::vector<int> pids;
+    std::vector<char> data;           // One fixed-size slot per file per PID
+    std::vector<char> paths;          // "<pid>/<file>" per slot, relative to /proc
+    std::vector<ssize_t> lengths;
+    std::vector<int> fds;
+    std::vector<bool> pendingSlots;   // Submitted and not yet completed
+    std::vector<bool> lateSlots;      // Gave up waiting; completion is discarded
+    size_t outstanding = 0;
+    bool finished = false;
+
+    ProcPreread get(size_t index) const;
+};
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+class ProcUringReader {
+private:
+    int ringFd = -1;
+    int procDirFd = -1;
+    unsigned sqEntries = 0;
+    unsigned cqEntries = 0;
+    size_t inFlight = 0;
+    uint32_t lastGeneration = 0;
+    std::unordered_map<uint32_t, std::shared_ptr<ProcReadBatch>> batches;
+
+    void* sqRing = nullptr;
+    void* cqRing = nullptr;
+    size_t sqRingSize = 0;
+    size_t cqRingSize = 0;
+    size_t sqesSize = 0;
+    io_uring_sqe* sqes = nullptr;
+    unsigned* sqHead = nullptr;
+    unsigned* sqTail = nullptr;
+    unsigned* sqMask = nullptr;
+    unsigned* sqArray = nullptr;
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned* cqMask = nullptr;
+    io_uring_cqe* cqes = nullptr;
+
+    void releaseRing();
+    void queue(uint8_t opcode, int fd, uint64_t address, unsigned length, uint64_t userData);
+    void reap();
+    unsigned unsubmitted() const;
+    void submitQueued(ProcReadBatch& batch);
+    std::vector<size_t> runPhase(ProcReadBatch& batch, uint8_t opcode, const std::vector<size_t>& slots,
+                                 std::chrono::steady_clock::time_point deadline);
+
+public:
+    ProcUringReader();
+    ~ProcUringReader();
+
+    ProcUringReader(const ProcUringReader&) = delete;
+    ProcUringReader& operator=(const ProcUringReader&) = delete;
+
+    bool available() const { return ringFd >= 0; }
+    std::shared_ptr<ProcReadBatch> readAll(const std::vector<int>& pids, std::chrono::milliseconds deadline,
+                                           ProcFile memoryFile);
+};
+
+//------------------------------------------------------------------------------
+// Process Identity Cache
+//------------------------------------------------------------------------------
+// What a process is, as opposed to what it is doing; stable until exec or exit
+struct ProcessIdentity {
+    int pid;
+    unsigned long long startTime;   // stat field 22, distinguishes reused PIDs
+    std::string comm;               // comm when resolved, a change means exec
+    std::string name;               // Executable basename from cmdline
+    std::string cmdline;            // Full command line, arguments separated by spaces
+    bool provisional;               // name is comm because cmdline could not be read in time
+};
+
+class ProcessIdentityCache {
+private:
+    std::unordered_map<int, std::shared_ptr<const ProcessIdentity>> identities;
+    std::mutex mutex;
+
+public:
+    std::shared_ptr<const ProcessIdentity> resolve(int pid, const ProcStat& stat);
+    void invalidate(int pid);
+    void forget(int pid);
+};
+
+extern ProcessIdentityCache g_processIdentities;
+
+//------------------------------------------------------------------------------
+// Command Line Search Index
+//------------------------------------------------------------------------------
+// Trigram index over the command lines of live processes. Each process
+// identity is a document; posting lists hold document ids in ascending
+// order because ids are handed out in increasing order. Exited processes
+// are only marked dead and skipped, and the lists are rebuilt once dead
+// documents outnumber live ones. A search intersects the lists of the
+// needle's trigrams and verifies the few candidates.
+class CmdlineIndex {
+private:
+    struct Document {
+        std::shared_ptr<const ProcessIdentity> identity;
+        unsigned long long seenInSync;  // Last sync() that found the process alive
+        bool live;
+    };
+
+    std::vector<Document> documents;                              // By document id
+    std::unordered_map<uint32_t, std::vector<uint32_t>> postings; // Trigram -> document ids
+    std::unordered_map<int, uint32_t> documentOfPid;              // Live documents only
+    std::vector<uint32_t> trigramScratch;
+    unsigned long long syncCount = 0;
+    size_t deadDocuments = 0;
+    mutable std::mutex mutex;
+
+    void add(const std::shared_ptr<const ProcessIdentity>& identity);
+    void remove(uint32_t document);
+    void compact();
+    void indexDocument(uint32_t document);
+
+public:
+    void sync(const std::vector<ProcessInfo>& processes);
+    bool search(std::string_view needle, std::vector<std::pair<int, unsigned long long>>& matches) const;
+    size_t size() const;
+};
+
+extern CmdlineIndex g_cmdlineIndex;
+
+bool ContainsIgnoreCase(std::string_view haystack, std::string_view lowerNeedle);
+
+//------------------------------------------------------------------------------
+// PID Enumeration
+//------------------------------------------------------------------------------
+// Difference between two consecutive PID scans (each list sorted ascending)
+struct PidSetDelta {
+    std::vector<int> added;
+    std::vector<int> removed;
+    std::vector<int> retained;
+};
+
+class PidEnumerator {
+private:
+    int procDirFd = -1;
+    std::vector<char> buffer;       // Reusable getdents64 buffer
+    std::vector<int> current;       // Sorted PIDs of the latest scan
+    std::vector<int> previous;      // Sorted PIDs of the scan before it
+    std::vector<int> gone;          // apply() scratch: sorted exited PIDs
+    std::vector<int> reused;        // apply() scratch: PIDs that exited and were forked again
+    PidSetDelta delta;
+
+    void diff();
+
+public:
+    PidEnumerator();
+    ~PidEnumerator();
+
+    PidEnumerator(const PidEnumerator&) = delete;
+    PidEnumerator& operator=(const PidEnumerator&) = delete;
+
+    bool scan();
+    void apply(const std::vector<int>& spawned, const std::vector<int>& exited);
+    const std::vector<int>& pids() const { return current; }
+    const PidSetDelta& changes() const { return delta; }
+};
+
+//------------------------------------------------------------------------------
+// Process Lifecycle Events (netlink proc connector)
+//------------------------------------------------------------------------------
+// Events received since the last drain (PIDs are thread-group ids)
+struct ProcEventBatch {
+    std::vector<int> spawned;
+    std::vector<int> execed;
+    std::vector<int> exited;
+    bool overflowed = false;   // Events were lost; a full /proc rescan is needed
+};
+
+class ProcEventListener {
+private:
+    int socketFd = -1;
+    std::atomic<bool> running{false};
+    std::thread receiver;
+    std::function<void(int)> exitCallback;
+    ProcEventBatch pending;
+    std::mutex mutex;
+    std::unordered_set<int> lingeringLeaders;   // Leaders that exited while other threads kept running
+
+    void receiveLoop();
+    void reportExit(int pid);
+
+public:
+    ProcEventListener() = default;
+    ~ProcEventListener();
+
+    ProcEventListener(const ProcEventListener&) = delete;
+    ProcEventListener& operator=(const ProcEventListener&) = delete;
+
+    bool start(std::function<void(int)> onExit);
+    void stop();
+    void drain(ProcEventBatch& batch);
+    bool isRunning() const { return running; }
+};
+
+//------------------------------------------------------------------------------
+// cgroup v2 Collector
+//------------------------------------------------------------------------------
+// Figures of one cgroup. cgroup v2 counters include every descendant, so
+// they cover the whole subtree. Figures the kernel does not provide for the
+// cgroup (controller not enabled, or the root cgroup) are negative.
+struct CgroupInfo {
+    std::string path;               // Relative to the cgroup2 mount, "/" for the root
+    std::string name;               // Last path component
+    int32_t parent;                 // Index of the parent node, -1 for the root
+    uint32_t depth;
+    uint32_t subtreeSize;           // Nodes in the subtree, this one included
+    float cpuUsage;                 // Like the process table, 100% is one full core
+    long long memoryBytes;          // memory.current
+    float throttledPercent;         // Share of CFS periods in which the cgroup was throttled
+    float throttledMsPerSec;        // Time spent throttled per second
+    double readBytesPerSec;         // io.stat, summed over devices
+    double writeBytesPerSec;
+    float cpuPressureSome;          // cpu.pressure avg10 (%)
+    float cpuPressureFull;
+};
+
+// Result of one pass over the cgroup hierarchy, published whole like ProcessSnapshot
+struct CgroupSnapshot {
+    unsigned long long generation;
+    std::chrono::steady_clock::time_point takenAt;
+    std::string mountPoint;         // Empty when no cgroup2 hierarchy is mounted
+    std::vector<CgroupInfo> nodes;  // Depth-first pre-order, children by name
+    unsigned long long syscalls;    // Spent on the pass
+};
+
+std::shared_ptr<const CgroupSnapshot> LatestCgroupSnapshot();
+
+// Walks the cgroup2 hierarchy once per collector pass. The tree of cgroups
+// and their open descriptors persist between passes: each pass re-lists the
+// directories it knows, opens files only for cgroups that appeared and
+// closes those of cgroups that went away; the rest is one pread per file.
+class CgroupCollector {
+private:
+    enum CgroupFile { CpuStat, MemoryCurrent, IoStat, CpuPressure, FileCount };
+
+    struct Counters {
+        unsigned long long usageUsec = 0;
+        unsigned long long periods = 0;
+        unsigned long long throttledPeriods = 0;
+        unsigned long long throttledUsec = 0;
+        unsigned long long readBytes = 0;
+        unsigned long long writeBytes = 0;
+        std::chrono::steady_clock::time_point takenAt;
+        bool valid = false;
+    };
+
+    struct Node {
+        int dirFd = -1;                               // -1 when over the descriptor budget
+        std::array<int, FileCount> fds;               // -1 when closed, -2 when the file is absent
+        unsigned passesSinceProbe = 0;                // Absent files are looked for again now and then
+        ino64_t inode = 0;                            // Tells a recreated cgroup of the same name apart
+        std::map<std::string, std::unique_ptr<Node>> children;
+        Counters previous;
+        Node() { fds.fill(-1); }
+    };
+
+    int rootFd = -1;
+    std::string mountPoint;
+    std::unique_ptr<Node> root;
+    size_t openFds = 0;
+    size_t fdBudget = 0;
+    unsigned long long syscalls = 0;
+    std::vector<char> buffer;                        // Reusable getdents64 and file buffer
+    std::vector<std::pair<std::string, ino64_t>> names;  // Directory listing scratch: (name, inode)
+
+    void walk(Node& node, const std::string& path, const std::string& name, int32_t parent, uint32_t depth,
+              std::vector<CgroupInfo>& out, std::chrono::steady_clock::time_point now);
+    bool listChildren(Node& node, const std::string& path);
+    ssize_t readFile(Node& node, const std::string& path, CgroupFile file);
+    int openAt(Node& node, const std::string& path, const char* name, int flags);
+    void release(Node& node);
+
+public:
+    CgroupCollector();
+    ~CgroupCollector();
+
+    CgroupCollector(const CgroupCollector&) = delete;
+    CgroupCollector& operator=(const CgroupCollector&) = delete;
+
+    bool available() const { return rootFd >= 0; }
+    std::shared_ptr<CgroupSnapshot> collect(unsigned long long generation);
+};
+
+//------------------------------------------------------------------------------
+// Worker Pool
+//------------------------------------------------------------------------------
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable taskAvailable;
+    std::condition_variable idle;
+    size_t unfinishedTasks = 0;
+    bool stopping = false;
+
+    void workerLoop();
+
+public:
+    explicit ThreadPool(size_t threadCount);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(std::function<void()> task);
+    void waitIdle();
+    void shutdown();
+    size_t size() const { return workers.size(); }
+};
 extern std::vector<ProcessInfo> updateProcessList;
 
+//------------------------------------------------------------------------------
+// Process Table Ordering
+//------------------------------------------------------------------------------
+// Sortable columns of the process table (also used as ImGui column user ids)
+enum class ProcessColumn : uint8_t {
+    Pid,
+    Name,
+    State,
+    Cpu,
+    Memory,
+    IoRead,
+    IoWrite,
+    IoSyscalls,
+    Rss,
+    RssAnon,
+    RssFile,
+    RssShmem,
+    Swap,
+    Threads,
+    Pss,
+    Uss
+};
+
+struct ProcessSortSpec {
+    ProcessColumn column = ProcessColumn::Pid;
+    bool descending = false;
+
+    bool operator==(const ProcessSortSpec& other) const {
+        return column == other.column && descending == other.descending;
+    }
+    bool operator!=(const ProcessSortSpec& other) const { return !(*this == other); }
+};
+
+// Row counts from which sorting is split across a worker pool
+constexpr size_t PARALLEL_SORT_THRESHOLD = 32768;
+
+// Sorted permutation of the rows of a snapshot. It is only recomputed when
+// the snapshot or the sort spec changes. Between consecutive snapshots with
+// the same spec, rows whose sort key did not change keep their relative
+// order, so only the changed rows are sorted and merged back in.
+class ProcessOrder {
+private:
+    std::shared_ptr<const ProcessSnapshot> snapshot;  // Snapshot the rows refer to
+    ProcessSortSpec spec;
+    std::vector<uint32_t> order;
+    std::vector<uint32_t> retained;                   // Scratch for incremental updates
+    std::vector<uint32_t> changed;
+    std::vector<uint8_t> seen;
+    std::unique_ptr<ThreadPool> sortPool;             // Created on first large sort
+
+    void sortRows(std::vector<uint32_t>& rows);
+    void sortAll();
+    void sortIncremental(const ProcessTable& previous);
+
+public:
+    bool update(const std::shared_ptr<const ProcessSnapshot>& latest, const ProcessSortSpec& latestSpec);
+    const std::vector<uint32_t>& rows() const { return order; }
+};
+
+// Rows of the K processes using the most CPU or memory, highest first, left
+// out the ones reported exited. It holds row indices into the snapshot
+// instead of copying process data. Between consecutive scans only the rows
+// the scan sampled can change value, so the previous top K and those rows
+// go through a K-element heap; the whole table is scanned (O(n log K)) only
+// when that cannot prove the result, or when K or the metric changes.
+class TopConsumers {
+private:
+    using Identity = std::pair<int, unsigned long long>;  // (pid, starttime)
+
+    std::shared_ptr<const ProcessSnapshot> snapshot;  // Snapshot the rows refer to
+    ProcessColumn metric = ProcessColumn::Cpu;
+    size_t k = 0;
+    size_t exitedSeen = 0;                            // Size of the exited set the rows were selected with
+    std::vector<uint32_t> top;
+    std::vector<uint32_t> skipped;                    // Rows left out as exited
+    std::vector<uint32_t> candidates;                 // Scratch for incremental updates
+
+    void selectAll(const std::set<Identity>& exited);
+    bool selectIncremental(const ProcessSnapshot& previous, const std::set<Identity>& exited);
+    void selectTop(const std::vector<uint32_t>& rows, const std::set<Identity>& exited);
+
+public:
+    bool update(const std::shared_ptr<const ProcessSnapshot>& latest, ProcessColumn latestMetric, size_t latestK,
+                const std::set<std::pair<int, unsigned long long>>& exited);
+    const std::vector<uint32_t>& rows() const { return top; }
+};
+
+// Compiled filter query for the process table. Terms are separated by
+// spaces and must all match:
+//   text        case-insensitive substring of the name or command line
+//   name:text   case-insensitive substring of the name only
+//   ^text       case-insensitive prefix of the name
+//   /regex/     case-insensitive ECMAScript regex on the name
+//   state:RD    state letter is one of the given letters
+//   cpu>5       numeric comparison on cpu, mem or pid with <, <=, >, >=, =
+// Matches are cached per row and recomputed only when the query or the
+// snapshot changes; name terms are evaluated once per distinct name and
+// command line terms go through the trigram index.
+class ProcessFilter {
+private:
+    enum class TermKind : uint8_t { Text, Substring, Prefix, Regex, State, Numeric };
+    enum class Compare : uint8_t { Less, LessEqual, Greater, GreaterEqual, Equal };
+
+    struct Term {
+        TermKind kind;
+        std::string text;       // Lower-cased for name terms, state letters for State
+        std::regex pattern;
+        ProcessColumn column;   // Numeric field
+        Compare compare;
+        double value;
+        std::vector<uint8_t> rows;  // Text terms: per-row result for the current snapshot
+    };
+
+    std::string query;                                 // Query the terms were compiled from
+    std::vector<Term> terms;
+    bool hasNameTerms = false;
+    std::string compileError;
+    std::shared_ptr<const ProcessSnapshot> snapshot;   // Snapshot the matches were computed for
+    std::vector<uint8_t> rowMatches;
+    std::vector<int8_t> nameMatches;                   // Per name id: -1 unknown, 0 no, 1 yes
+
+    bool compile(const std::string& text);
+    void matchText(Term& term, const ProcessTable& table);
+    bool matchesName(const std::string& name) const;
+    bool matchesRow(const ProcessTable& table, uint32_t row);
+
+public:
+    bool update(const char* text, const std::shared_ptr<const ProcessSnapshot>& latest);
+    bool matches(uint32_t row) const { return terms.empty() || rowMatches[row]; }
+    bool active() const { return !terms.empty(); }
+    const std::string& error() const { return compileError; }
+};
+
+// State of the process table widget kept across frames
+struct ProcessTableView {
+    std::shared_ptr<const ProcessSnapshot> snapshot;         // Scan being shown
+    std::set<std::pair<int, unsigned long long>> selected;   // (pid, starttime), so a recycled PID is not selected
+    std::set<std::pair<int, unsigned long long>> exited;     // Reported exited since the scan was taken
+    std::set<std::pair<int, unsigned long long>> collapsed;  // Tree mode: subtrees folded by the user
+    bool treeMode = false;                                   // Show parent/child tree instead of a sorted list
+    ProcessSortSpec sortSpec;
+    ProcessOrder order;
+    ProcessFilter filter;
+    std::vector<uint32_t> visibleRows;                       // Sorted rows that pass the filter, or tree rows
+                                                             // outside collapsed subtrees
+    bool visibleDirty = true;
+};
+
+void RenderProcessTable(ProcessTableView& view, const char* filterText);
+
 //------------------------------------------------------------------------------
 // Rendering Functions
 //------------------------------------------------------------------------------
@@ -292,6 +292,7 @@ int main(int, char **)
     }
 
     // Cleanup
+    StopFetchingProcesses();
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplSDL2_Shutdown();
     ImGui::DestroyContext();
@@ -82,17 +82,22 @@ void GetDiskUsage(float &diskUsedPercentage, std::string &usedStorageStr, std::s
 // Function to fetch detailed information about a specific process
 // Parameters:
 //   pid: Process ID to fetch information for
+//   snapshot: System-wide values captured once for the current scan
+//   preread: stat and status or statm contents already read by a batched reader, or nullptr
 // Returns:
 //   ProcessInfo struct containing process details like name, state, CPU/memory usage
-ProcessInfo FetchProcessInfo(int pid) {
+ProcessInfo FetchProcessInfo(int pid, const SystemSnapshot &snapshot, const ProcPreread *preread) {
     // Initialize ProcessInfo struct with default values
     ProcessInfo process;
     process.pid = pid;
+    process.ppid = 0;
+    process.startTime = 0;
     process.isActive = false;  // Process is considered inactive until proven otherwise
     process.name = "Unknown";  // Default name if we can't determine the real name
-    process.state = "Unknown"; // Default state if we can't determine the real state
+    process.state = ProcState::Unknown; // Default state if we can't determine the real state
     process.cpuUsage = 0.0f;  // Default CPU usage
     process.memoryUsage = 0.0f; // Default memory usage
+    process.readBytesPerSec = process.writeBytesPerSec = process.ioSyscallsPerSec = -1.0f; // n/a
 
     try {
         // Validate PID
@@ -100,58 +105,63 @@ ProcessInfo FetchProcessInfo(int pid) {
             throw std::runtime_error("Invalid PID");
         }
 
-        // Try to get process name from cmdline file
-        // This usually contains the full command line used to start the process
-        std::string cmdPath = "/proc/" + std::to_string(pid) + "/cmdline";
-        std::ifstream cmdFile(cmdPath);
-        std::string cmdLine;
-        if (cmdFile && std::getline(cmdFile, cmdLine, '\0')) {
-            if (!cmdLine.empty()) {
-                // Extract just the executable name without the full path
-                size_t lastSlash = cmdLine.find_last_of('/');
-                if (lastSlash != std::string::npos) {
-                    process.name = cmdLine.substr(lastSlash + 1);
-                } else {
-                    process.name = cmdLine;
-                }
-            }
-        }
-
-        // Get process state and fallback name from stat file
+        // Get process state, identity and CPU times from stat file
         // Format: pid (name) state ...
-        std::string statPath = "/proc/" + std::to_string(pid) + "/stat";
-        std::ifstream statFile(statPath);
-        std::string line;
-        
-        if (statFile && std::getline(statFile, line)) {
-            size_t firstParen = line.find('(');
-            size_t lastParen = line.rfind(')');
-            
-            // Ensure we found valid parentheses and have content after them
-            if (firstParen != std::string::npos && lastParen != std::string::npos && 
-                firstParen < lastParen && lastParen + 2 < line.length()) {
-                
-                // If we couldn't get name from cmdline, use the one from stat
-                if (process.name == "Unknown") {
-                    process.name = line.substr(firstParen + 1, lastParen - firstParen - 1);
-                }
-                
-                // Parse process state character (R:running, S:sleeping, etc)
-                std::istringstream iss(line.substr(lastParen + 2)); // Skip ') '
-                std::string state;
-                if (iss >> state) {
-                    process.state = state;
-                }
-            }
+        char statBuffer[PROC_STAT_BUFFER_SIZE];
+        ProcStat stat{};
+        bool haveStat = preread && !preread->stat.empty()
+            ? ParseProcStat(preread->stat, stat)
+            : ReadProcStat(pid, statBuffer, sizeof(statBuffer), stat);
+        if (!haveStat) {
+            // Process exited since the scan - drop its accounting state
+            g_cpuUsageCalculator.forget(pid);
+            g_ioUsageCalculator.forget(pid);
+            g_procFdCache.forget(pid);
+            g_processIdentities.forget(pid);
+            g_deadlineReader.forget(pid);
+            return process;
         }
 
+        // Name and command line only change on exec, so they come from the identity cache
+        std::shared_ptr<const ProcessIdentity> identity = g_processIdentities.resolve(pid, stat);
+        process.startTime = identity->startTime;
+        process.name = identity->name;
+        process.identity = identity;
+
+        // Parent may change while the process runs (reparenting when the parent exits)
+        process.ppid = stat.ppid;
+
+        // Process state character (R:running, S:sleeping, etc)
+        process.state = ProcStateFromChar(stat.state);
+
         // Get CPU and memory usage statistics
-        float cpuUsage = GetCPUUsage(pid);
-        if (cpuUsage >= 0.0f) {  // Negative value indicates error
-            process.cpuUsage = cpuUsage;
-            process.memoryUsage = GetMemUsage(pid);
-            process.isActive = true;  // Mark process as active if we got valid CPU usage
+        process.cpuUsage = GetCPUUsage(pid, stat, snapshot);
+        process.lastCpuUpdateTime = std::chrono::steady_clock::now();
+        // One memory file per process: the batch already holds status or statm, whichever it read
+        ProcessMemory& memory = process.memory;
+        bool haveMemory;
+        if (preread && !preread->status.empty()) {
+            haveMemory = ParseProcStatus(preread->status, memory);
+        } else if (preread && !preread->statm.empty()) {
+            haveMemory = ParseProcStatm(preread->statm, snapshot.pageSize, memory);
+        } else {
+            haveMemory = GetProcessMemory(pid, g_collectMemoryDetail, snapshot, memory);
+        }
+        if (!haveMemory) {
+            // The file is unreadable or quarantined - fall back to the rss field of stat
+            memory = ProcessMemory{};
+            memory.rssKb = static_cast<long long>(stat.rssPages) * (snapshot.pageSize / 1024);
         }
+        if (memory.threads < 0) {
+            memory.threads = stat.numThreads;
+        }
+        process.memoryUsage = snapshot.totalMemoryKb > 0
+            ? static_cast<float>(memory.rssKb) / snapshot.totalMemoryKb * 100 : 0.0f;
+        // Disk I/O is one more file per process, so it is only read while its columns are shown
+        if (g_collectIo) {
+            GetIoUsage(pid, identity->startTime, process);
+        }
+        process.isActive = true;  // Mark process as active once its stat file was parsed
 
     } catch (const std::exception& e) {
         // Log any errors but continue - return process with default values
@@ -160,64 +170,452 @@ ProcessInfo FetchProcessInfo(int pid) {
 
     return process;
 }
+// Number of event-driven cycles between full /proc rescans that resync the PID set
+static constexpr int PROC_RESCAN_INTERVAL_CYCLES = 15;
+
+// Longest back-off, in cycles, between two samples of a process that stays idle
+static constexpr unsigned PROC_SAMPLE_MAX_INTERVAL_CYCLES = 16;
+
+// Batch per-cycle /proc reads through io_uring (set from the UI; off by default)
+std::atomic<bool> g_useIoUring(false);
+// Whether the last cycle actually used io_uring (false when the kernel lacks it)
+std::atomic<bool> g_ioUringActive(false);
+
+// Read /proc/<pid>/io for the disk I/O columns (set from the UI; off by default)
+std::atomic<bool> g_collectIo(false);
+// Read /proc/<pid>/status instead of statm for the memory breakdown columns (set from the UI)
+std::atomic<bool> g_collectMemoryDetail(false);
+// Read /proc/<pid>/smaps_rollup for the PSS/USS columns (set from the UI; off by default),
+// spending at most 20 ms per pass
+std::atomic<bool> g_collectPss(false);
+std::atomic<int> g_pssBudgetUs(20000);
+
+// Each pass is spread over 10 slices of 200 ms; a slice may use 20 ms of CPU
+std::atomic<int> g_scanSlices(10);
+std::atomic<int> g_sliceCpuBudgetUs(20000);
+
+// Reads of a slice are submitted in waves of this many per worker, checking the budget in between
+static constexpr size_t PROC_SLICE_WAVE_PER_WORKER = 4;
+
+// Latest complete scan; only accessed through std::atomic_load/std::atomic_store
+static std::shared_ptr<const ProcessSnapshot> latestProcessSnapshot;
+
+/**
+ * Returns the most recently published scan without blocking the collector
+ *
+ * @return Latest snapshot, or nullptr before the first scan completes
+ */
+std::shared_ptr<const ProcessSnapshot> LatestProcessSnapshot() {
+    return std::atomic_load(&latestProcessSnapshot);
+}
+
+// Latest pass over the cgroup hierarchy, published the same way
+static std::shared_ptr<const CgroupSnapshot> latestCgroupSnapshot;
+
+/**
+ * Returns the most recently published cgroup pass without blocking the collector
+ *
+ * @return Latest snapshot, or nullptr before the first pass completes
+ */
+std::shared_ptr<const CgroupSnapshot> LatestCgroupSnapshot() {
+    return std::atomic_load(&latestCgroupSnapshot);
+}
+
+/**
+ * Packs the results of one scan into an immutable snapshot
+ *
+ * @param results One entry per scanned PID; inactive entries (exited or skipped) are left out
+ * @param sampled PIDs read during the scan; every other entry repeats its earlier sample
+ * @param generation Scan number
+ * @param takenAt Time the scan started
+ * @param pass Cost and timing of the scan
+ * @param tree Parent index the rows are laid out with
+ * @param names Interner shared with earlier snapshots; replaced by a private copy
+ *              before new names are added while published snapshots still use it
+ * @return Snapshot ready to publish
+ */
+static std::shared_ptr<const ProcessSnapshot> BuildProcessSnapshot(const std::vector<ProcessInfo>& results,
+                                                                   const std::vector<int>& sampled,
+                                                                   unsigned long long generation,
+                                                                   std::chrono::steady_clock::time_point takenAt,
+                                                                   const ScanPassStats& pass,
+                                                                   ProcessTree& tree,
+                                                                   std::shared_ptr<NameInterner>& names) {
+    for (const ProcessInfo& process : results) {
+        if (process.isActive && !names->contains(process.name)) {
+            if (names.use_count() > 1) {
+                names = std::make_shared<NameInterner>(*names);
+            }
+            break;
+        }
+    }
+
+    auto snapshot = std::make_shared<ProcessSnapshot>(
+        ProcessSnapshot{generation, takenAt, ProcessTable(names), pass, ProcessTreeLayout{}, {}});
+    snapshot->table.reserve(results.size());
+    for (const ProcessInfo& process : results) {
+        if (process.isActive && process.cpuUsage > -1) {
+            snapshot->table.append(process, names->intern(process.name));
+        }
+    }
+    tree.layout(snapshot->table, snapshot->tree);
+
+    snapshot->sampledRows.reserve(sampled.size());
+    for (int pid : sampled) {
+        ptrdiff_t row = snapshot->table.find(pid);
+        if (row >= 0) {
+            snapshot->sampledRows.push_back(static_cast<uint32_t>(row));
+        }
+    }
+    return snapshot;
+}
+
+// Shutdown signalling shared between the fetch loop and StopFetchingProcesses()
+static std::mutex fetchStateMutex;
+static std::condition_variable fetchStateChanged;
+static std::atomic<bool> stopFetchingRequested(false);
+static bool fetchLoopRunning = false;
+
+/**
+ * Sleeps until the given time, waking early if the fetch loop is asked to stop
+ *
+ * @param until Time to wake up at; returns at once if it has passed
+ * @return true if a stop was requested
+ */
+static bool WaitUntilOrStop(std::chrono::steady_clock::time_point until) {
+    std::unique_lock<std::mutex> lock(fetchStateMutex);
+    return fetchStateChanged.wait_until(lock, until, []() { return stopFetchingRequested.load(); });
+}
+
+/**
+ * Returns the CPU time consumed so far by the calling thread
+ */
+static std::chrono::nanoseconds ThreadCpuTime() {
+    timespec now{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return std::chrono::seconds(now.tv_sec) + std::chrono::nanoseconds(now.tv_nsec);
+}
+
+/**
+ * Returns the batched reader, created on first use and kept for the life of the process
+ * Destroying a ring with reads still blocked in the kernel would leave their
+ * buffers to be parked, so toggling io_uring off only stops using the reader.
+ * Only the collector thread calls this.
+ */
+static ProcUringReader& SharedUringReader() {
+    static ProcUringReader reader;
+    return reader;
+}
+
+/**
+ * Reads the processes of one slice on the worker pool until the slice's CPU budget is spent
+ * Reads go out in waves of a few per worker and the budget is checked between waves,
+ * so a slice overshoots it by at most one wave. The first wave always runs so every
+ * slice makes progress however small the budget.
+ *
+ * @param workers Pool running the reads
+ * @param items Indexes into pids of the processes to read, in order
+ * @param pids PIDs due this pass
+ * @param budget CPU time the slice may use, 0 for unlimited
+ * @param uring Batched reader for stat and the memory file, or nullptr for direct reads
+ * @param samples One slot per entry of pids, filled for the items read
+ * @param cpuTime Output, CPU time the slice used across workers and this thread
+ * @return Number of leading items that were read
+ */
+static size_t RunScanSlice(ThreadPool& workers, const std::vector<size_t>& items, const std::vector<int>& pids,
+                           std::chrono::nanoseconds budget, ProcUringReader* uring,
+                           std::vector<ProcessInfo>& samples, std::chrono::nanoseconds& cpuTime) {
+    // Global CPU times are captured per slice, when the slice's processes are read
+    const SystemSnapshot snapshot = CaptureSystemSnapshot();
+    const size_t waveSize = std::max<size_t>(1, workers.size()) * PROC_SLICE_WAVE_PER_WORKER;
+    std::atomic<long long> workerNanos(0);
+    std::chrono::nanoseconds collectorTime{};
+    std::vector<int> wavePids;
+    std::vector<ptrdiff_t> waveSlots;   // Per wave item, its index in the batch or -1 if not batched
+
+    size_t processed = 0;
+    while (processed < items.size() && !stopFetchingRequested) {
+        if (processed > 0 && budget.count() > 0 &&
+            collectorTime + std::chrono::nanoseconds(workerNanos.load()) >= budget) {
+            break; // The rest is carried over to the next slice
+        }
+        size_t waveEnd = std::min(items.size(), processed + waveSize);
+
+        // With io_uring enabled, read stat and the memory file of the whole wave up front from this thread
+        std::shared_ptr<ProcReadBatch> prereads;
+        if (uring) {
+            std::chrono::nanoseconds start = ThreadCpuTime();
+            wavePids.clear();
+            waveSlots.assign(waveEnd - processed, -1);
+            for (size_t i = processed; i < waveEnd; i++) {
+                // A quarantined PID would stall every phase of the batch until the deadline again;
+                // it is read directly instead, where its memory falls back to the rss field of stat
+                int pid = pids[items[i]];
+                if (g_deadlineReader.isQuarantined(pid)) {
+                    continue;
+                }
+                waveSlots[i - processed] = static_cast<ptrdiff_t>(wavePids.size());
+                wavePids.push_back(pid);
+            }
+            prereads = uring->readAll(wavePids, PROC_READ_DEADLINE,
+                                      g_collectMemoryDetail ? ProcFile::Status : ProcFile::Statm);
+            collectorTime += ThreadCpuTime() - start;
+        }
+
+        // One work item per PID; each writes only its own slot, so no locking is needed
+        for (size_t i = processed; i < waveEnd; i++) {
+            ptrdiff_t slot = prereads ? waveSlots[i - processed] : -1;
+            workers.submit([index = items[i], slot, &pids, &snapshot, &prereads, &samples, &workerNanos]() {
+                // Skip work still queued when a shutdown is requested
+                if (stopFetchingRequested) {
+                    return;
+                }
+                std::chrono::nanoseconds start = ThreadCpuTime();
+                ProcPreread preread;
+                if (slot >= 0) {
+                    preread = prereads->get(static_cast<size_t>(slot));
+                }
+                samples[index] = FetchProcessInfo(pids[index], snapshot, slot >= 0 ? &preread : nullptr);
+                workerNanos.fetch_add((ThreadCpuTime() - start).count(), std::memory_order_relaxed);
+            });
+        }
+
+        // The tasks reference this frame, so the wave is drained before moving on
+        workers.waitIdle();
+        processed = waveEnd;
+    }
+
+    cpuTime = collectorTime + std::chrono::nanoseconds(workerNanos.load());
+    return processed;
+}
+
 /**
- * Continuously fetches process information from the system in a multi-threaded way.
- * This function runs in an infinite loop, periodically scanning /proc directory
- * for active processes and gathering their information.
+ * Continuously fetches process information from the system using a fixed-size worker pool.
+ * This function runs until StopFetchingProcesses() is called, periodically scanning /proc
+ * for active processes and handing each PID to the pool as a work item. Each pass is
+ * spread over the slices of PROC_SCAN_INTERVAL rather than read in one burst.
+ * The pool is owned by this loop, so its workers are joined when the loop exits.
  */
 void StartFetchingProcesses() {
-    // Counter for tracking number of threads currently running
-    std::atomic<int> activeThreads(0);
-    
-    // Vector to store process IDs found in /proc
-    std::vector<int> pids;
-    pids.reserve(1000); // Pre-allocate reasonable initial capacity for efficiency
+    {
+        std::lock_guard<std::mutex> lock(fetchStateMutex);
+        fetchLoopRunning = true;
+    }
+
+    // One worker per core keeps the thread count constant regardless of PID count
+    ThreadPool workers(std::thread::hardware_concurrency());
+
+    // Lists /proc with a reusable getdents64 buffer and diffs against the previous scan
+    PidEnumerator enumerator;
+
+    // Keeps the PID set current from fork/exit events when the kernel allows it
+    // (needs CAP_NET_ADMIN); otherwise every cycle falls back to a full rescan
+    ProcEventListener events;
+    bool eventsActive = events.start([](int pid) {
+        // Tell the UI right away so the row is hidden without waiting for the next scan
+        ProcessInfo exited{};
+        exited.pid = pid;
+        exited.isActive = false;
+        g_exitedProcesses.push(std::move(exited));
+    });
+    ProcEventBatch batch;
+
+    int cyclesSinceRescan = PROC_RESCAN_INTERVAL_CYCLES; // Forces a full scan on the first cycle
+    unsigned long long scanGeneration = 0;
+
+    // Samples busy processes every cycle and backs idle ones off up to the cap
+    SampleScheduler sampler(PROC_SAMPLE_MAX_INTERVAL_CYCLES);
+    std::vector<int> duePids;
+    bool lastCollectIo = g_collectIo;
+    bool lastCollectMemoryDetail = g_collectMemoryDetail;
+
+    // Name ids stay stable across snapshots. Workers write samples by index, one slot
+    // per due PID; results holds the latest sample of every PID for the snapshot.
+    std::shared_ptr<NameInterner> names = std::make_shared<NameInterner>();
+    std::vector<ProcessInfo> samples;
+    std::vector<ProcessInfo> results;
+
+    // Parent -> children index, updated from each sample and each exited PID
+    ProcessTree tree;
+    std::vector<int> orphans;
+
+    // Reads per-cgroup counters, which the kernel already aggregates per subtree
+    CgroupCollector cgroups;
+
+    // Shards each pass over the slices of the interval
+    ScanSlicer slicer;
+    unsigned long long overruns = 0;
+    bool lastPassOverran = false;
 
     while (true) {
-        pids.clear(); // Reuse vector instead of recreating to avoid memory allocation
-
-        // Open /proc directory using raw pointer for faster directory access
-        DIR* dir = opendir("/proc");
-        if (!dir) {
-            std::cerr << "Failed to open /proc directory." << std::endl;
-            // Brief sleep before retry if directory open fails
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            continue;
-        }
-
-        // Scan directory entries for process directories (numbered directories)
-        struct dirent* entry;
-        while ((entry = readdir(dir)) != nullptr) {
-            // Check if entry is a directory and name is a number (valid PID)
-            if (entry->d_type == DT_DIR && isNumber(entry->d_name)) {
-                pids.push_back(std::stoi(entry->d_name));
+        const std::chrono::steady_clock::time_point passStart = std::chrono::steady_clock::now();
+        bool scanned = true;
+        if (eventsActive) {
+            events.drain(batch);
+
+            // Processes that exec'd get their name and command line fetched again
+            for (int pid : batch.execed) {
+                g_processIdentities.invalidate(pid);
+                sampler.wake(pid);
+            }
+        }
+
+        // Rescan /proc when events are unavailable or lost, and periodically to resync
+        if (!eventsActive || batch.overflowed || cyclesSinceRescan >= PROC_RESCAN_INTERVAL_CYCLES) {
+            scanned = enumerator.scan();
+            cyclesSinceRescan = 0;
+        } else {
+            enumerator.apply(batch.spawned, batch.exited);
+            cyclesSinceRescan++;
+        }
+
+        if (scanned) {
+            // Forget CPU samples, descriptors and identities of processes that have exited
+            for (int pid : enumerator.changes().removed) {
+                g_cpuUsageCalculator.forget(pid);
+                g_ioUsageCalculator.forget(pid);
+                g_procFdCache.forget(pid);
+                g_processIdentities.forget(pid);
+                g_deadlineReader.forget(pid);
+                g_pssSampler.forget(pid);
+                sampler.forget(pid);
+                // Reparented children are read again so they move under their new parent
+                tree.remove(pid, orphans);
+                for (int orphan : orphans) {
+                    sampler.wake(orphan);
+                }
             }
+        } else {
+            std::cerr << "Failed to read /proc directory." << std::endl;
         }
-        closedir(dir);
-
-        // Process PIDs in batches to limit concurrent threads
-        const int BATCH_SIZE = 50;  // Maximum number of concurrent threads per batch
-        for (size_t i = 0; i < pids.size(); i += BATCH_SIZE) {
-            // Calculate end index for current batch
-            size_t end = std::min(i + BATCH_SIZE, pids.size());
-            
-            // Launch a new thread for each PID in the batch
-            for (size_t j = i; j < end; j++) {
-                activeThreads++;
-                // Create detached thread to process individual PID
-                std::thread([pid = pids[j], &activeThreads]() {
-                    try {
-                        // Fetch process info and add to global queue
-                        ProcessInfo process = FetchProcessInfo(pid);
-                        g_completedProcesses.push(std::move(process));
-                    } catch (...) { /* Silently ignore errors to prevent thread crashes */ }
-                    activeThreads--;  // Decrease active thread count when done
-                }).detach();
+        static const std::vector<int> noPids;
+        const std::vector<int>& pids = scanned ? enumerator.pids() : noPids;
+
+        // Toggling the disk I/O or memory breakdown columns changes what a sample holds,
+        // so every process is read again
+        bool collectIo = g_collectIo;
+        bool collectMemoryDetail = g_collectMemoryDetail;
+        if (collectIo != lastCollectIo || collectMemoryDetail != lastCollectMemoryDetail) {
+            for (int pid : pids) {
+                sampler.wake(pid);
             }
+            lastCollectIo = collectIo;
+            lastCollectMemoryDetail = collectMemoryDetail;
         }
 
-        // Wait before starting next scan cycle
-        // Shorter sleep time since GetCPUUsage already includes a 3s delay
-        std::this_thread::sleep_for(std::chrono::milliseconds(2000));
+        // Only processes that are new, changed recently or whose back-off expired are read this cycle
+        if (scanned) {
+            sampler.advance(pids, duePids);
+        } else {
+            duePids.clear();
+        }
+
+        // The batched reader is created the first time io_uring is enabled and kept from then on
+        ProcUringReader* uring = g_useIoUring ? &SharedUringReader() : nullptr;
+        g_ioUringActive = uring && uring->available();
+        ProcUringReader* batchedReader = g_ioUringActive ? uring : nullptr;
+
+        // Spread the due PIDs over the slices of the interval instead of reading them in
+        // one burst. Slice k starts k slice lengths into the pass; empty slices are skipped.
+        const unsigned slices = std::clamp(g_scanSlices.load(), 1, PROC_SCAN_MAX_SLICES);
+        const std::chrono::nanoseconds sliceBudget(std::chrono::microseconds(std::max(0, g_sliceCpuBudgetUs.load())));
+        const std::chrono::steady_clock::duration sliceLength =
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(PROC_SCAN_INTERVAL) / slices;
+        const unsigned long long generation = ++scanGeneration;
+
+        // A few files per cgroup, read once per pass from this thread
+        std::atomic_store(&latestCgroupSnapshot, std::shared_ptr<const CgroupSnapshot>(cgroups.collect(generation)));
+        slicer.plan(duePids, slices);
+        samples.assign(duePids.size(), ProcessInfo{});
+
+        ScanPassStats pass;
+        pass.plannedSlices = slices;
+        pass.sampled = duePids.size();
+        bool stopped = false;
+        while (slicer.pending()) {
+            const std::vector<size_t>& items = slicer.nextSlice();
+            unsigned slice = pass.slicesRun++;
+            if (items.empty()) {
+                slicer.finishSlice(0);
+                continue;
+            }
+            if (slice > 0 && WaitUntilOrStop(passStart + sliceLength * slice)) {
+                stopped = true;
+                break;
+            }
+            std::chrono::nanoseconds sliceCpu{};
+            slicer.finishSlice(RunScanSlice(workers, items, duePids, sliceBudget, batchedReader, samples, sliceCpu));
+            pass.cpuTime += sliceCpu;
+            pass.maxSliceCpuTime = std::max(pass.maxSliceCpuTime, sliceCpu);
+        }
+        stopped = stopped || stopFetchingRequested;
+        pass.deferred = slicer.deferred();
+        pass.wallTime = std::chrono::steady_clock::now() - passStart;
+
+        // Report passes that spilled past their interval, logging only when overrunning starts
+        pass.overran = !stopped && pass.wallTime > PROC_SCAN_INTERVAL;
+        if (pass.overran) {
+            if (!lastPassOverran) {
+                std::cerr << "Process scan took "
+                          << std::chrono::duration_cast<std::chrono::milliseconds>(pass.wallTime).count()
+                          << " ms, longer than its " << PROC_SCAN_INTERVAL.count() << " ms interval ("
+                          << pass.sampled << " reads, deferred " << pass.deferred << " times by the slice CPU budget)"
+                          << std::endl;
+            }
+            overruns++;
+        }
+        lastPassOverran = pass.overran;
+        pass.overruns = overruns;
+
+        // Publish the whole pass with one pointer swap. An interrupted or failed
+        // scan is incomplete and keeps the previous snapshot on screen.
+        if (scanned && !stopped) {
+            for (size_t i = 0; i < duePids.size(); i++) {
+                if (samples[i].isActive) {
+                    tree.update(duePids[i], samples[i].ppid);
+                } else {
+                    tree.remove(duePids[i], orphans);
+                    for (int orphan : orphans) {
+                        sampler.wake(orphan);
+                    }
+                }
+                sampler.record(duePids[i], std::move(samples[i]));
+            }
+            sampler.collect(pids, results);
+            // PSS is read after the pass, outside its slices, so it never delays the regular reads
+            if (g_collectPss) {
+                g_pssSampler.sample(results, std::chrono::microseconds(std::max(0, g_pssBudgetUs.load())), pass);
+            }
+            g_cmdlineIndex.sync(results);
+            std::atomic_store(&latestProcessSnapshot,
+                              BuildProcessSnapshot(results, duePids, generation, passStart, pass, tree, names));
+        }
+
+        // Start the next pass one interval after this one started (at once after an
+        // overrun), or retry shortly if the directory could not be read
+        auto nextPass = scanned ? passStart + PROC_SCAN_INTERVAL
+                                : std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+        if (stopped || WaitUntilOrStop(nextPass)) {
+            break;
+        }
     }
+
+    // Join the event thread and the workers before reporting that the loop is gone
+    events.stop();
+    workers.shutdown();
+
+    std::lock_guard<std::mutex> lock(fetchStateMutex);
+    fetchLoopRunning = false;
+    fetchStateChanged.notify_all();
+}
+
+/**
+ * Asks the fetch loop to stop and waits until it has joined its workers.
+ * Returns immediately if the loop is not running.
+ */
+void StopFetchingProcesses() {
+    std::unique_lock<std::mutex> lock(fetchStateMutex);
+    stopFetchingRequested = true;
+    fetchStateChanged.notify_all();
+    fetchStateChanged.wait(lock, []() { return !fetchLoopRunning; });
 }
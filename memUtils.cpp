@@ -205,146 +205,169 @@ std::pair< std::pair<long, long>, std::pair<std::string, std::string> > getDiskU
 }
 
 /**
- * Gets memory usage percentage for a specific process
- * Reads from /proc/<pid>/status file to get resident memory usage
- * 
- * @param pid Process ID to check memory usage for
- * @return Memory usage as percentage of total system memory
+ * Captures the system-wide values needed by per-process computations
+ * Called once per scan so /proc/stat and sysconf are read O(1) times per scan
+ * instead of once or twice per PID
+ *
+ * @return Snapshot of global CPU times, total memory and system constants
  */
-float GetMemUsage(int pid){
-    // Open process status file
-    std::string path = "/proc/" + std::to_string(pid) + "/status";
-    std::ifstream statusFile(path);
-    std::string line;
-    float memUsage = 0.0f;
-
-    // Look for VmRSS line which shows resident memory usage
-    while(std::getline(statusFile,line)){
-        if (line.find("VmRSS:") == 0) {
-            std::istringstream iss(line);
-            std::string key;
-            int value;
-            std::string unit;
-            iss >> key >> value >> unit;
-            // Calculate percentage of total system memory
-            memUsage = static_cast<float>(value) / (sysconf(_SC_PHYS_PAGES) * sysconf(_SC_PAGE_SIZE) / 1024) * 100;
-            break;
-        }
+SystemSnapshot CaptureSystemSnapshot() {
+    SystemSnapshot snapshot{};
+    snapshot.takenAt = std::chrono::steady_clock::now();
+
+    // Get system constants
+    snapshot.clockTicksPerSecond = sysconf(_SC_CLK_TCK);
+    snapshot.numCores = std::max(1L, sysconf(_SC_NPROCESSORS_ONLN));
+    snapshot.pageSize = sysconf(_SC_PAGE_SIZE);
+    snapshot.totalMemoryKb = static_cast<unsigned long long>(sysconf(_SC_PHYS_PAGES)) * snapshot.pageSize / 1024;
+
+    // Get system-wide CPU times from the aggregate "cpu" line
+    std::ifstream cpuFile("/proc/stat");
+    std::string cpuLabel;
+    CPUStats& cpu = snapshot.cpu;
+    if (cpuFile >> cpuLabel >> cpu.user >> cpu.nice >> cpu.system >> cpu.idle
+                >> cpu.iowait >> cpu.irq >> cpu.softirq >> cpu.steal) {
+        snapshot.totalCpuTicks = cpu.user + cpu.nice + cpu.system + cpu.idle
+                               + cpu.iowait + cpu.irq + cpu.softirq + cpu.steal;
+    } else {
+        std::cerr << "Failed to parse CPU data from /proc/stat" << std::endl;
+        snapshot.cpu = CPUStats{};
+    }
+
+    return snapshot;
+}
+
+/**
+ * Gets the memory of a specific process
+ * Only the resident total is needed by default, and /proc/<pid>/statm holds it
+ * in one short line. The breakdown (anon, file, shmem, swap) is only in
+ * /proc/<pid>/status, which is several times larger and is read only when asked.
+ *
+ * @param pid Process ID to check memory for
+ * @param detail Read status for the full breakdown instead of statm
+ * @param snapshot System values of the current scan (provides the page size)
+ * @param memory Receives the sizes; fields that were not read are left as they were
+ * @return true if the file was read and parsed, false if it could not be read in time
+ */
+bool GetProcessMemory(int pid, bool detail, const SystemSnapshot &snapshot, ProcessMemory &memory){
+    if (detail) {
+        // Read process status file through the descriptor cache, bounded by a deadline
+        const char* status = nullptr;
+        ssize_t length = g_deadlineReader.read(pid, ProcFile::Status, true, PROC_STATUS_BUFFER_SIZE, status);
+        return length > 0 && ParseProcStatus(std::string_view(status, length), memory);
+    }
+
+    // statm only sums the mm counters and never takes the mm lock, so no deadline is needed.
+    // A PID quarantined by a hung batched read is still skipped; stat's rss stands in.
+    if (g_deadlineReader.isQuarantined(pid)) {
+        return false;
+    }
+    char buffer[PROC_STAT_BUFFER_SIZE];
+    ssize_t length = g_procFdCache.read(pid, ProcFile::Statm, buffer, sizeof(buffer));
+    return length > 0 && ParseProcStatm(std::string_view(buffer, length), snapshot.pageSize, memory);
+}
+
+/**
+ * Gets the proportional and unique set size of a specific process
+ * smaps_rollup walks every mapping under the process's mm lock, so the read
+ * is bounded by a deadline, and it is opened once instead of through the
+ * descriptor cache: only a few processes are read per pass, and keeping
+ * their descriptors would evict the ones every scan needs.
+ *
+ * @param pid Process ID to read
+ * @param pss Receives pssKb and ussKb, stamped with the time of the read
+ * @return true if the file was read and parsed
+ */
+bool GetProcessPss(int pid, ProcessPss &pss){
+    const char* rollup = nullptr;
+    ssize_t length = g_deadlineReader.read(pid, ProcFile::SmapsRollup, false, PROC_STATUS_BUFFER_SIZE, rollup);
+    if (length <= 0 || !ParseSmapsRollup(std::string_view(rollup, length), pss)) {
+        return false;
     }
-    return memUsage;
+    pss.sampledAt = std::chrono::steady_clock::now();
+    return true;
 }
 
 /**
  * Gets CPU usage percentage for a specific process
- * Takes two measurements of process and system CPU time to calculate usage
+ * Takes the CPU times already parsed from /proc/<pid>/stat and lets
+ * g_cpuUsageCalculator compute usage from the delta against the sample
+ * taken in the previous scan cycle
  * 
  * @param pid Process ID to check CPU usage for
- * @return CPU usage percentage or -1.0 on error
+ * @param stat Parsed stat fields of the process
+ * @param snapshot System values of the current scan
+ * @return CPU usage percentage (0.0 on first sighting)
  */
-float GetCPUUsage(int pid) {
-    std::string pidStr = std::to_string(pid);
-    std::string statPath = "/proc/" + pidStr + "/stat";
-
-    // Helper lambda to measure process and system CPU time
-    auto measure = [&]() -> std::pair<long, long> {
-        // Open process stat file
-        std::ifstream statFile(statPath);
-        if (!statFile.is_open()) {
-            // std::cerr << "Could not open file: " << statPath << std::endl;
-            return {-1, -1};
-        }
-
-        // Read process stats
-        std::string statLine;
-        if (!std::getline(statFile, statLine)) {
-            std::cerr << "Failed to read from file: " << statPath << std::endl;
-            return {-1, -1};
-        }
-
-        // Parse stat line into fields
-        std::istringstream iss(statLine);
-        std::vector<std::string> statFields;
-        std::string field;
+float GetCPUUsage(int pid, const ProcStat &stat, const SystemSnapshot &snapshot) {
+    ProcessStats sample;
+    sample.startTime = stat.startTime;
+    sample.utime = stat.utime;    // user mode time
+    sample.stime = stat.stime;    // system mode time
+    sample.cutime = stat.cutime;  // waited-for children user time
+    sample.cstime = stat.cstime;  // waited-for children system time
+    sample.systemTicks = snapshot.totalCpuTicks;
+    sample.sampleTime = std::chrono::steady_clock::now();
+
+    return g_cpuUsageCalculator.update(pid, sample, snapshot);
+}
 
-        while (iss >> field) {
-            statFields.push_back(field);
-        }
+/**
+ * Gets disk I/O rates for a specific process
+ * Reads /proc/<pid>/io through the descriptor cache and lets g_ioUsageCalculator
+ * compute rates from the delta against the previous sample. The file needs
+ * ptrace access to the process; a refusal is remembered so the process is
+ * shown as n/a without being tried again on every scan.
+ *
+ * @param pid Process ID to check I/O for
+ * @param startTime Start time of the process
+ * @param process Receives the rates; left negative (n/a) if the file cannot be read
+ */
+void GetIoUsage(int pid, unsigned long long startTime, ProcessInfo &process) {
+    if (g_ioUsageCalculator.denied(pid, startTime)) {
+        return;
+    }
 
-        // Check we have enough fields
-        if (statFields.size() < 15) {
-            std::cerr << "Insufficient data in stat file for PID: " << pid << std::endl;
-            return {-1, -1};
+    // Unlike status, io does not take the target's mm lock, so no deadline is needed
+    char buffer[512];
+    ssize_t length = g_procFdCache.read(pid, ProcFile::Io, buffer, sizeof(buffer));
+    if (length <= 0) {
+        if (length < 0 && (errno == EACCES || errno == EPERM)) {
+            g_ioUsageCalculator.deny(pid, startTime);
         }
+        return;
+    }
 
-        // Get process CPU times
-        long utime = std::stol(statFields[13]);  // user mode time
-        long stime = std::stol(statFields[14]);  // system mode time
-        long total_time = utime + stime;
-
-        // Get system-wide CPU times
-        std::ifstream cpuFile("/proc/stat");
-        if (!cpuFile.is_open()) {
-            std::cerr << "Could not open /proc/stat" << std::endl;
-            return {-1, -1};
+    // "key: value" lines: rchar, wchar, syscr, syscw, read_bytes, write_bytes, cancelled_write_bytes
+    ProcessIoStats sample{};
+    sample.startTime = startTime;
+    sample.sampleTime = std::chrono::steady_clock::now();
+    std::string_view io(buffer, length);
+    while (!io.empty()) {
+        size_t colon = io.find(':');
+        size_t end = io.find('\n');
+        if (colon == std::string_view::npos || colon > end) {
+            break;
         }
-
-        std::string cpuLine;
-        if (!std::getline(cpuFile, cpuLine)) {
-            std::cerr << "Failed to read from /proc/stat" << std::endl;
-            return {-1, -1};
+        std::string_view key = io.substr(0, colon);
+        unsigned long long value = 0;
+        for (size_t i = colon + 1; i < io.size() && i < end; i++) {
+            if (io[i] >= '0' && io[i] <= '9') {
+                value = value * 10 + (io[i] - '0');
+            }
         }
-
-        // Parse CPU times from stat file
-        std::istringstream cpuStream(cpuLine);
-        std::string cpuLabel;
-        long user, nice, system, idle, iowait, irq, softirq, steal;
-        if (!(cpuStream >> cpuLabel >> user >> nice >> system >> idle >> iowait >> irq >> softirq >> steal)) {
-            std::cerr << "Failed to parse CPU data from /proc/stat" << std::endl;
-            return {-1, -1};
+        if (key == "read_bytes") {
+            sample.readBytes = value;
+        } else if (key == "write_bytes") {
+            sample.writeBytes = value;
+        } else if (key == "syscr" || key == "syscw") {
+            sample.syscalls += value;
         }
-        long total_system_time = user + nice + system + idle + iowait + irq + softirq + steal;
-
-        return {total_time, total_system_time};
-    };
-
-    // Take first measurement
-    auto [total_time1, system_time1] = measure();
-    if (total_time1 < 0 || system_time1 < 0) return -1.0;
-
-    // Wait 3 seconds between measurements
-    std::this_thread::sleep_for(std::chrono::milliseconds(3000));  // 1-second interval
-
-    // Take second measurement
-    auto [total_time2, system_time2] = measure();
-    if (total_time2 < 0 || system_time2 < 0) return -1.0;
-
-    // Get system constants
-    long hertz = sysconf(_SC_CLK_TCK);
-    if (hertz <= 0) {
-        std::cerr << "Invalid clock ticks per second" << std::endl;
-        return -1.0;
-    }
-
-    long numCores = sysconf(_SC_NPROCESSORS_ONLN);
-    if (numCores <= 0) {
-        std::cerr << "Invalid number of CPU cores" << std::endl;
-        return -1.0;
+        io.remove_prefix(end == std::string_view::npos ? io.size() : end + 1);
     }
 
-    // Calculate time differences
-    float total_time_diff = static_cast<float>(total_time2 - total_time1) ;
-    float system_time_diff = static_cast<float>(system_time2 - system_time1) ;
-
-    if (system_time_diff <= 0) {
-        std::cerr << "Invalid system time difference" << std::endl;
-        return -1.0;
-    }
-
-    // Calculate CPU usage percentage (total_time_diff is the process time, system_time_diff is overall CPU time)
-    float cpuUsage = 100.0 * (total_time_diff / system_time_diff);
-
-    // Multiply by the number of cores to match top's calculation
-    cpuUsage *= numCores;
-
-    return cpuUsage;
+    IoRates rates = g_ioUsageCalculator.update(pid, sample);
+    process.readBytesPerSec = rates.readBytesPerSec;
+    process.writeBytesPerSec = rates.writeBytesPerSec;
+    process.ioSyscallsPerSec = rates.syscallsPerSec;
 }
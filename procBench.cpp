@@ -0,0 +1,125 @@
+#include "header.h"
+
+// Collector benchmark: compares the synchronous per-file reads, the
+// io_uring batched reader and adaptive sampling over scans of /proc. Costs
+// are averaged over the second half of the scans, once caches are warm and
+// the adaptive back-off has settled.
+//
+// Usage: ./procbench [scans]
+
+namespace {
+
+struct BenchResult {
+    double millisPerScan = 0;
+    double syscallsPerScan = 0;
+    size_t processes = 0;
+};
+
+/**
+ * Runs a number of collector scans back to back and averages their cost
+ *
+ * @param scans Number of scans to run
+ * @param useIoUring Whether to pre-read stat/status through io_uring
+ * @param adaptive Whether to sample only the PIDs the SampleScheduler marks due
+ * @return Average wall time and /proc syscalls per scan
+ */
+BenchResult RunScans(int scans, bool useIoUring, bool adaptive) {
+    ThreadPool workers(std::max(1u, std::thread::hardware_concurrency()));
+    PidEnumerator enumerator;
+    std::unique_ptr<ProcUringReader> uring;
+    if (useIoUring) {
+        uring = std::make_unique<ProcUringReader>();
+    }
+
+    SampleScheduler sampler(16);
+    std::vector<int> duePids;
+    std::vector<ProcessInfo> samples;
+
+    BenchResult result;
+    std::chrono::steady_clock::duration elapsed{};
+    unsigned long long syscalls = 0;
+    int warmupScans = scans / 2;
+
+    for (int scan = 0; scan < scans; scan++) {
+        unsigned long long syscallsBefore = g_procSyscalls;
+        auto start = std::chrono::steady_clock::now();
+
+        enumerator.scan();
+        const std::vector<int> &pids = enumerator.pids();
+        if (adaptive) {
+            for (int pid : enumerator.changes().removed) {
+                sampler.forget(pid);
+            }
+            sampler.advance(pids, duePids);
+        } else {
+            duePids = pids;
+        }
+        SystemSnapshot snapshot = CaptureSystemSnapshot();
+
+        std::shared_ptr<ProcReadBatch> prereads;
+        if (uring) {
+            prereads = uring->readAll(duePids, PROC_READ_DEADLINE, ProcFile::Statm);
+        }
+        samples.assign(duePids.size(), ProcessInfo{});
+        for (size_t i = 0; i < duePids.size(); i++) {
+            workers.submit([pid = duePids[i], i, &snapshot, &prereads, &samples]() {
+                ProcPreread preread;
+                if (prereads) {
+                    preread = prereads->get(i);
+                }
+                samples[i] = FetchProcessInfo(pid, snapshot, prereads ? &preread : nullptr);
+            });
+        }
+        workers.waitIdle();
+        if (adaptive) {
+            for (size_t i = 0; i < duePids.size(); i++) {
+                sampler.record(duePids[i], std::move(samples[i]));
+            }
+        }
+
+        if (scan >= warmupScans) {
+            elapsed += std::chrono::steady_clock::now() - start;
+            syscalls += g_procSyscalls - syscallsBefore;
+        }
+        result.processes = pids.size();
+    }
+
+    int measuredScans = scans - warmupScans;
+    result.millisPerScan = std::chrono::duration<double, std::milli>(elapsed).count() / measuredScans;
+    result.syscallsPerScan = static_cast<double>(syscalls) / measuredScans;
+    return result;
+}
+
+void PrintResult(const char *label, const BenchResult &result) {
+    printf("%-10s %8zu %12.2f %14.0f %14.2f\n", label, result.processes, result.millisPerScan,
+           result.syscallsPerScan,
+           result.processes ? result.syscallsPerScan / result.processes : 0.0);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    int scans = argc > 1 ? std::max(2, atoi(argv[1])) : 64;
+
+    printf("%-10s %8s %12s %14s %14s\n", "backend", "procs", "ms/scan", "syscalls/scan", "syscalls/proc");
+    // Drops the descriptors cached by a previous run so every run starts cold
+    auto dropCachedDescriptors = []() {
+        PidEnumerator cached;
+        cached.scan();
+        for (int pid : cached.pids()) {
+            g_procFdCache.forget(pid);
+        }
+    };
+
+    PrintResult("sync", RunScans(scans, false, false));
+    dropCachedDescriptors();
+    PrintResult("adaptive", RunScans(scans, false, true));
+    dropCachedDescriptors();
+
+    if (!ProcUringReader().available()) {
+        printf("%-10s io_uring is not available on this kernel\n", "io_uring");
+        return 0;
+    }
+    PrintResult("io_uring", RunScans(scans, true, false));
+    return 0;
+}
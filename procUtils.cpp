@@ -0,0 +1,304 @@
+#include "header.h"
+
+// Syscalls the collector has issued against /proc, used to report scan cost
+std::atomic<unsigned long long> g_procSyscalls(0);
+
+namespace {
+
+// Fields of /proc/<pid>/stat that the collector needs, numbered as in proc(5).
+// Everything else on the line is skipped without being decoded.
+constexpr int kNeededStatFields[] = {
+    3,   // state
+    4,   // ppid
+    14,  // utime
+    15,  // stime
+    16,  // cutime
+    17,  // cstime
+    20,  // num_threads
+    22,  // starttime
+    24,  // rss
+};
+
+// Bit N is set when field N is needed, so the scan loop tests membership in O(1)
+constexpr uint64_t BuildStatFieldMask() {
+    uint64_t mask = 0;
+    for (int field : kNeededStatFields) {
+        mask |= 1ULL << field;
+    }
+    return mask;
+}
+
+// Highest needed field - the scan stops as soon as it has been decoded
+constexpr int LastNeededStatField() {
+    int last = 0;
+    for (int field : kNeededStatFields) {
+        last = std::max(last, field);
+    }
+    return last;
+}
+
+constexpr uint64_t kStatFieldMask = BuildStatFieldMask();
+constexpr int kLastStatField = LastNeededStatField();
+static_assert(kLastStatField < 64, "stat field mask only covers fields 0-63");
+
+/**
+ * Decodes a (possibly negative) decimal integer in place
+ *
+ * @param begin First character of the token
+ * @param end One past the last character of the token
+ * @return Decoded value; stops at the first non-digit
+ */
+long long DecodeInteger(const char* begin, const char* end) {
+    bool negative = begin < end && *begin == '-';
+    if (negative) {
+        begin++;
+    }
+    long long value = 0;
+    for (; begin < end && *begin >= '0' && *begin <= '9'; begin++) {
+        value = value * 10 + (*begin - '0');
+    }
+    return negative ? -value : value;
+}
+
+/**
+ * Stores one needed field into the output structure
+ */
+void StoreStatField(int field, const char* begin, const char* end, ProcStat& out) {
+    switch (field) {
+        case 3:  out.state = *begin; break;
+        case 4:  out.ppid = static_cast<int>(DecodeInteger(begin, end)); break;
+        case 14: out.utime = DecodeInteger(begin, end); break;
+        case 15: out.stime = DecodeInteger(begin, end); break;
+        case 16: out.cutime = DecodeInteger(begin, end); break;
+        case 17: out.cstime = DecodeInteger(begin, end); break;
+        case 20: out.numThreads = DecodeInteger(begin, end); break;
+        case 22: out.startTime = DecodeInteger(begin, end); break;
+        case 24: out.rssPages = DecodeInteger(begin, end); break;
+        default: break;
+    }
+}
+
+// Lines of /proc/<pid>/status that the collector needs, with the member each one fills
+struct StatusField {
+    std::string_view key;       // Including the colon
+    long long ProcessMemory::*kb;
+};
+
+constexpr StatusField kNeededStatusFields[] = {
+    {"VmRSS:", &ProcessMemory::rssKb},
+    {"RssAnon:", &ProcessMemory::anonKb},
+    {"RssFile:", &ProcessMemory::fileKb},
+    {"RssShmem:", &ProcessMemory::shmemKb},
+    {"VmSwap:", &ProcessMemory::swapKb},
+};
+
+// Threads: is stored as a count, not in kB, so it is matched separately
+constexpr std::string_view kStatusThreadsKey = "Threads:";
+
+/**
+ * Skips the blanks between a status key and its value and decodes the value
+ *
+ * @param begin First character after the key
+ * @param end End of the line
+ * @return Decoded value
+ */
+long long DecodeStatusValue(const char* begin, const char* end) {
+    while (begin < end && (*begin == ' ' || *begin == '\t')) {
+        begin++;
+    }
+    return DecodeInteger(begin, end);
+}
+
+} // namespace
+
+/**
+ * Parses the memory lines of /proc/<pid>/status without allocating
+ * The file is walked line by line once; only lines whose key is one of
+ * kNeededStatusFields or Threads are decoded, and the walk stops once all of
+ * them were seen. Processes without an address space (kernel threads) have no
+ * Vm/Rss lines, so every size starts at 0 rather than n/a.
+ *
+ * @param status Contents of the status file
+ * @param out Parsed sizes in kB and the thread count
+ * @return true if the Threads line was found, false for a truncated or malformed file
+ */
+bool ParseProcStatus(std::string_view status, ProcessMemory& out) {
+    out.rssKb = out.anonKb = out.fileKb = out.shmemKb = out.swapKb = 0;
+    out.threads = -1;
+
+    constexpr size_t kNeededLines = sizeof(kNeededStatusFields) / sizeof(kNeededStatusFields[0]) + 1;
+    size_t seen = 0;
+    const char* cursor = status.data();
+    const char* end = cursor + status.size();
+    while (cursor < end && seen < kNeededLines) {
+        const char* lineEnd = static_cast<const char*>(memchr(cursor, '\n', end - cursor));
+        if (!lineEnd) {
+            lineEnd = end;
+        }
+        std::string_view line(cursor, lineEnd - cursor);
+        cursor = lineEnd + 1;
+
+        // Every needed key starts with V, R or T; most lines are rejected on their first byte
+        if (line.empty() || (line[0] != 'V' && line[0] != 'R' && line[0] != 'T')) {
+            continue;
+        }
+        if (line.compare(0, kStatusThreadsKey.size(), kStatusThreadsKey) == 0) {
+            out.threads = static_cast<long>(DecodeStatusValue(line.data() + kStatusThreadsKey.size(), lineEnd));
+            seen++;
+            continue;
+        }
+        for (const StatusField& field : kNeededStatusFields) {
+            if (line.compare(0, field.key.size(), field.key) == 0) {
+                out.*field.kb = DecodeStatusValue(line.data() + field.key.size(), lineEnd);
+                seen++;
+                break;
+            }
+        }
+    }
+    return out.threads >= 0;
+}
+
+/**
+ * Parses /proc/<pid>/statm, which holds only page counts
+ * Its second field is the resident set, the same total as VmRSS; the
+ * breakdown and thread count are left untouched.
+ *
+ * @param statm Contents of the statm file ("size resident shared text lib data dt")
+ * @param pageSize Page size in bytes
+ * @param out Receives rssKb
+ * @return true if the resident field was present
+ */
+bool ParseProcStatm(std::string_view statm, long pageSize, ProcessMemory& out) {
+    size_t space = statm.find(' ');
+    if (space == std::string_view::npos) {
+        return false;
+    }
+    const char* begin = statm.data() + space + 1;
+    const char* end = statm.data() + statm.size();
+    if (begin >= end || *begin < '0' || *begin > '9') {
+        return false;
+    }
+    out.rssKb = DecodeInteger(begin, end) * (pageSize / 1024);
+    return true;
+}
+
+/**
+ * Parses /proc/<pid>/smaps_rollup without allocating
+ * USS is the sum of the private clean and dirty pages; the walk stops once
+ * the three lines were seen, before the swap and THP lines.
+ *
+ * @param rollup Contents of the smaps_rollup file
+ * @param out Receives pssKb and ussKb; sampledAt is left to the caller
+ * @return true if the Pss line was found (the file is empty for kernel threads)
+ */
+bool ParseSmapsRollup(std::string_view rollup, ProcessPss& out) {
+    constexpr std::string_view kPssKey = "Pss:";
+    constexpr std::string_view kPrivateCleanKey = "Private_Clean:";
+    constexpr std::string_view kPrivateDirtyKey = "Private_Dirty:";
+
+    long long pss = -1;
+    long long privateClean = -1;
+    long long privateDirty = -1;
+    const char* cursor = rollup.data();
+    const char* end = cursor + rollup.size();
+    while (cursor < end && (pss < 0 || privateClean < 0 || privateDirty < 0)) {
+        const char* lineEnd = static_cast<const char*>(memchr(cursor, '\n', end - cursor));
+        if (!lineEnd) {
+            lineEnd = end;
+        }
+        std::string_view line(cursor, lineEnd - cursor);
+        cursor = lineEnd + 1;
+
+        if (line.compare(0, kPssKey.size(), kPssKey) == 0) {
+            pss = DecodeStatusValue(line.data() + kPssKey.size(), lineEnd);
+        } else if (line.compare(0, kPrivateCleanKey.size(), kPrivateCleanKey) == 0) {
+            privateClean = DecodeStatusValue(line.data() + kPrivateCleanKey.size(), lineEnd);
+        } else if (line.compare(0, kPrivateDirtyKey.size(), kPrivateDirtyKey) == 0) {
+            privateDirty = DecodeStatusValue(line.data() + kPrivateDirtyKey.size(), lineEnd);
+        }
+    }
+    if (pss < 0) {
+        return false;
+    }
+    out.pssKb = pss;
+    out.ussKb = std::max(0LL, privateClean) + std::max(0LL, privateDirty);
+    return true;
+}
+
+/**
+ * Parses a /proc/<pid>/stat line without allocating
+ * The comm field may itself contain spaces and parentheses, so parsing starts
+ * after the LAST ')' on the line and walks the remaining fields once,
+ * decoding only those listed in kNeededStatFields.
+ *
+ * @param line Contents of the stat file
+ * @param out Parsed fields; out.comm points into line
+ * @return true if every needed field was present
+ */
+bool ParseProcStat(std::string_view line, ProcStat& out) {
+    size_t firstParen = line.find('(');
+    size_t lastParen = line.rfind(')');
+    if (firstParen == std::string_view::npos || lastParen == std::string_view::npos || lastParen < firstParen) {
+        return false;
+    }
+    out.comm = line.substr(firstParen + 1, lastParen - firstParen - 1);
+
+    const char* cursor = line.data() + lastParen + 1;
+    const char* end = line.data() + line.size();
+
+    // Field 3 (state) is the first one after the closing parenthesis
+    for (int field = 3; field <= kLastStatField; field++) {
+        while (cursor < end && *cursor == ' ') {
+            cursor++;
+        }
+        if (cursor >= end || *cursor == '\n') {
+            return false; // Line ended before every needed field was seen
+        }
+
+        const char* tokenStart = cursor;
+        while (cursor < end && *cursor != ' ' && *cursor != '\n') {
+            cursor++;
+        }
+
+        if (kStatFieldMask & (1ULL << field)) {
+            StoreStatField(field, tokenStart, cursor, out);
+        }
+    }
+    return true;
+}
+
+/**
+ * Reads and parses /proc/<pid>/stat
+ *
+ * @param pid Process ID
+ * @param buffer Buffer that receives the raw line; out.comm points into it
+ * @param capacity Size of the buffer
+ * @param out Parsed fields
+ * @return true on success, false if the process is gone or the line is malformed
+ */
+bool ReadProcStat(int pid, char* buffer, size_t capacity, ProcStat& out) {
+    ssize_t length = g_procFdCache.read(pid, ProcFile::Stat, buffer, capacity);
+    if (length <= 0) {
+        return false;
+    }
+    return ParseProcStat(std::string_view(buffer, length), out);
+}
+
+/**
+ * Checks whether a PID names a live process, with one read of its stat file
+ * The file is read without caching its descriptor, as the PID may be gone.
+ * A leader that exited while other threads keep running shows as a zombie,
+ * but its process is still alive.
+ *
+ * @param pid Process ID
+ * @return true if the process exists and has a thread that has not exited
+ */
+bool IsProcessAlive(int pid) {
+    char buffer[PROC_STAT_BUFFER_SIZE];
+    ssize_t length = g_procFdCache.readOnce(pid, ProcFile::Stat, buffer, sizeof(buffer));
+    ProcStat stat{};
+    if (length <= 0 || !ParseProcStat(std::string_view(buffer, length), stat)) {
+        return false;
+    }
+    return (stat.state != 'Z' && stat.state != 'X') || stat.numThreads > 1;
+}
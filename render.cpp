@@ -1,13 +1,12 @@
 #include "header.h"
 #include <chrono>  // For time tracking
 #include <unordered_set>
+#include <set>
 
 // Cache for process list and synchronization primitives
 static std::vector<ProcessInfo> processList;
 std::atomic<bool> g_isFetchingProcesses(false); 
-std::vector<ProcessInfo> displayProcessList;
 std::vector<ProcessInfo> updateProcessList;
-std::mutex processListMutex;
 std::atomic<bool> isUpdating(false);
 
 // Renders basic system information like OS, user, hostname etc.
@@ -36,11 +35,9 @@ void RenderSystemInfo() {
     ImGui::Text("CPU: %s", CPUinfo().c_str());
     ImGui::Spacing();
 
-    // Display process count with mutex protection
-    {
-        std::lock_guard<std::mutex> lock(processListMutex);
-        ImGui::Text("Total Processes: %zu", displayProcessList.size());
-    }
+    // Display process count of the latest published scan
+    std::shared_ptr<const ProcessSnapshot> processes = LatestProcessSnapshot();
+    ImGui::Text("Total Processes: %zu", processes ? processes->table.size() : 0);
 
     if (io.Fonts->Fonts.Size > 0) {
         ImGui::PopFont();
@@ -245,117 +242,742 @@ void RenderMemoryProcessMonitor() {
     ImGui::PopFont();
 }
 
-// Renders process monitor UI with filtering and sorting
-void RenderProcessMonitorUI() {
-    ImGui::PushFont(ImGui::GetIO().Fonts->Fonts[1]);
-    
-    static char filterText[64] = "";
-    static std::unordered_set<int> selectedPIDs;
-    static bool fetchThreadStarted = false;
+/**
+ * Switches the process table to a newly published scan
+ * Selections and exit marks of processes no longer listed are dropped.
+ *
+ * @param view Process table state
+ * @param latest Latest published snapshot
+ */
+static void ShowProcessSnapshot(ProcessTableView& view, std::shared_ptr<const ProcessSnapshot> latest) {
+    if (latest == view.snapshot) {
+        return;
+    }
+    view.snapshot = std::move(latest);
+    view.visibleDirty = true;
+
+    const ProcessTable& table = view.snapshot->table;
+    auto listed = [&table](const std::pair<int, unsigned long long>& identity) {
+        ptrdiff_t row = table.find(identity.first);
+        return row >= 0 && table.startTimes()[row] == identity.second;
+    };
+    for (auto* identities : {&view.selected, &view.exited, &view.collapsed}) {
+        for (auto it = identities->begin(); it != identities->end();) {
+            it = listed(*it) ? std::next(it) : identities->erase(it);
+        }
+    }
+}
 
-    // Start process fetching thread once
-    if (!fetchThreadStarted) {
-        fetchThreadStarted = true;
-        std::thread([]() {
-            StartFetchingProcesses();
-        }).detach();
+/**
+ * Hides a process the kernel reported as exited until the next scan drops it
+ *
+ * @param view Process table state
+ * @param pid Process ID from the exit event
+ */
+static void HideExitedProcess(ProcessTableView& view, int pid) {
+    ptrdiff_t row = view.snapshot ? view.snapshot->table.find(pid) : -1;
+    if (row >= 0) {
+        std::pair<int, unsigned long long> identity(pid, view.snapshot->table.startTimes()[row]);
+        view.selected.erase(identity);
+        view.exited.insert(identity);
+        view.visibleDirty = true;
     }
+}
 
-    // Process new results
-    ProcessInfo newProcess;
-    while (g_completedProcesses.try_pop(newProcess)) {
-        if (newProcess.cpuUsage > -1) {
-            std::lock_guard<std::mutex> lock(processListMutex);
-            
-            auto it = std::find_if(displayProcessList.begin(), displayProcessList.end(),
-                                 [&](const ProcessInfo& p) { return p.pid == newProcess.pid; });
-            
-            if (it != displayProcessList.end()) {
-                *it = newProcess;
-            } else {
-                displayProcessList.push_back(newProcess);
-            }    
+/**
+ * Makes the PSS sampler read the selected processes first in every pass
+ *
+ * @param view Process table state
+ */
+static void PrioritizeSelectedPss(const ProcessTableView& view) {
+    std::vector<int> pids;
+    pids.reserve(view.selected.size());
+    for (const auto& identity : view.selected) {
+        pids.push_back(identity.first);
+    }
+    g_pssSampler.prioritize(pids);
+}
+
+/**
+ * Rebuilds the sorted list of rows that pass the filter
+ *
+ * @param view Process table state
+ */
+static void UpdateVisibleRows(ProcessTableView& view) {
+    const ProcessTable& table = view.snapshot->table;
+    view.visibleRows.clear();
+    for (uint32_t row : view.order.rows()) {
+        if (table.name(row).empty() || !view.filter.matches(row)) {
+            continue;
+        }
+        if (!view.exited.empty() && view.exited.count({table.pids()[row], table.startTimes()[row]}) > 0) {
+            continue;
         }
+        view.visibleRows.push_back(row);
     }
+    view.visibleDirty = false;
+}
 
-    // Clean up and sort process list
-    {
-        std::lock_guard<std::mutex> lock(processListMutex);
-        displayProcessList.erase(
-            std::remove_if(displayProcessList.begin(), displayProcessList.end(),
-                          [](const ProcessInfo& p) { return p.cpuUsage <= -1 || !p.isActive; }),
-            displayProcessList.end()
-        );
+/**
+ * Rebuilds the rows of the tree mode: the pre-order minus collapsed subtrees
+ * Without a filter or exit marks a collapsed subtree is skipped whole, so the
+ * cost follows the rows shown rather than the rows folded away. Otherwise one
+ * reverse pass first marks the rows that match or have a matching descendant;
+ * ancestors stay listed so every match keeps its place in the tree.
+ *
+ * @param view Process table state
+ */
+static void UpdateVisibleTreeRows(ProcessTableView& view) {
+    const ProcessTable& table = view.snapshot->table;
+    const ProcessTreeLayout& tree = view.snapshot->tree;
+    const std::vector<uint32_t>& preorder = tree.preorder;
+    view.visibleRows.clear();
+
+    bool everyRow = !view.filter.active() && view.exited.empty();
+    std::vector<uint8_t> shown;
+    if (!everyRow) {
+        shown.assign(table.size(), 0);
+        for (size_t i = preorder.size(); i-- > 0;) {
+            uint32_t row = preorder[i];
+            if (!shown[row] && view.filter.matches(row) &&
+                (view.exited.empty() || view.exited.count({table.pids()[row], table.startTimes()[row]}) == 0)) {
+                shown[row] = 1;
+            }
+            if (shown[row] && tree.parentRow[row] >= 0) {
+                shown[tree.parentRow[row]] = 1;
+            }
+        }
+    }
 
-        std::sort(displayProcessList.begin(), displayProcessList.end(),
-                 [](const ProcessInfo& a, const ProcessInfo& b) { return a.pid < b.pid; });
+    for (size_t i = 0; i < preorder.size();) {
+        uint32_t row = preorder[i];
+        if (!everyRow && !shown[row]) {
+            i += tree.subtreeSize[row]; // Nothing below matches either
+            continue;
+        }
+        view.visibleRows.push_back(row);
+        bool folded = tree.subtreeSize[row] > 1 && !view.collapsed.empty() &&
+                      view.collapsed.count({table.pids()[row], table.startTimes()[row]}) > 0;
+        i += folded ? tree.subtreeSize[row] : 1;
     }
+    view.visibleDirty = false;
+}
 
-    ImGui::Text("Total Number of Processes: %zu", displayProcessList.size());
-    ImGui::InputTextWithHint("##Filter", "Filter processes...", filterText, IM_ARRAYSIZE(filterText));
+/**
+ * Renders the name cell of a tree row, indented by depth, with an arrow that
+ * folds the subtree. A folded row shows how many processes it hides.
+ *
+ * @param view Process table state
+ * @param row Row to render
+ * @param identity (pid, starttime) of the row
+ */
+static void RenderTreeNameCell(ProcessTableView& view, uint32_t row,
+                               const std::pair<int, unsigned long long>& identity) {
+    const ProcessTable& table = view.snapshot->table;
+    const ProcessTreeLayout& tree = view.snapshot->tree;
+
+    float indent = tree.depth[row] * ImGui::GetStyle().IndentSpacing * 0.5f;
+    if (indent > 0.0f) {
+        ImGui::Indent(indent);
+    }
 
-    if (displayProcessList.empty()) {
-        ImGui::Text("No processes found.");
-        ImGui::PopFont();
+    ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_NoTreePushOnOpen | ImGuiTreeNodeFlags_OpenOnArrow |
+                               ImGuiTreeNodeFlags_OpenOnDoubleClick;
+    bool hasChildren = tree.subtreeSize[row] > 1;
+    bool folded = hasChildren && view.collapsed.count(identity) > 0;
+    bool open;
+    if (hasChildren) {
+        ImGui::SetNextItemOpen(!folded);
+        open = folded ? ImGui::TreeNodeEx("##node", flags, "%s (+%u)", table.name(row).c_str(), tree.subtreeSize[row] - 1)
+                      : ImGui::TreeNodeEx("##node", flags, "%s", table.name(row).c_str());
+    } else {
+        open = ImGui::TreeNodeEx("##node", flags | ImGuiTreeNodeFlags_Leaf, "%s", table.name(row).c_str());
+    }
+    if (ImGui::IsItemHovered() && !table.cmdline(row).empty()) {
+        ImGui::SetTooltip("%s", table.cmdline(row).c_str());
+    }
+    if (hasChildren && open == folded) {
+        if (folded) {
+            view.collapsed.erase(identity);
+        } else {
+            view.collapsed.insert(identity);
+        }
+        view.visibleDirty = true;
+    }
+
+    if (indent > 0.0f) {
+        ImGui::Unindent(indent);
+    }
+}
+
+/**
+ * Formats a byte rate for a table cell
+ *
+ * @param bytesPerSec Rate, negative when the kernel does not provide it
+ * @return Rate with a unit, or "n/a"
+ */
+static std::string FormatRate(double bytesPerSec) {
+    return bytesPerSec < 0 ? "n/a" : formatBytes(static_cast<long long>(bytesPerSec)) + "/s";
+}
+
+/**
+ * Formats a memory size for a table cell
+ *
+ * @param kb Size in kB, negative when it was not read
+ * @return Size with a unit, or "n/a"
+ */
+static std::string FormatSizeKb(long long kb) {
+    return kb < 0 ? "n/a" : formatBytes(kb * 1024);
+}
+
+// Renders the sortable process table, or the process tree in tree mode; only
+// rows scrolled into view are submitted
+void RenderProcessTable(ProcessTableView& view, const char* filterText) {
+    if (!view.snapshot) {
         return;
     }
 
-    // Render process table
+    // Scroll inside the table so the header stays visible and the clipper can skip hidden rows
+    float minHeight = ImGui::GetTextLineHeightWithSpacing() * 10;
+    ImVec2 outerSize(0.0f, std::max(ImGui::GetContentRegionAvail().y, minHeight));
+
+    // The tree keeps its parent/child order, so it is not sortable and has its own column layout
+    bool treeMode = view.treeMode;
+    ImGuiTableFlags flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_Resizable |
+                            ImGuiTableFlags_ScrollY;
+    if (!treeMode) {
+        flags |= ImGuiTableFlags_Sortable;
+    }
+
+    // Disk I/O columns are shown while the collector reads /proc/<pid>/io, and the
+    // memory breakdown while it reads status instead of statm
+    bool showIo = g_collectIo;
+    bool showMemoryDetail = g_collectMemoryDetail;
+    bool showPss = g_collectPss;
+    int columnCount = 7 + (showMemoryDetail ? 4 : 0) + (showPss ? 3 : 0) + (showIo ? 3 : 0) + (treeMode ? 2 : 0);
+
     ImGui::PushStyleVar(ImGuiStyleVar_CellPadding, ImVec2(10, 5));
-    if (ImGui::BeginTable("ProcessTable", 5, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | 
-                         ImGuiTableFlags_Resizable | ImGuiTableFlags_Sortable)) {
+    if (ImGui::BeginTable(treeMode ? "ProcessTree" : "ProcessTable", columnCount, flags, outerSize)) {
         // Setup columns
-        ImGui::TableSetupColumn("PID", ImGuiTableColumnFlags_DefaultSort);
-        ImGui::TableSetupColumn("Name");
-        ImGui::TableSetupColumn("State");
-        ImGui::TableSetupColumn("CPU Usage (%)", ImGuiTableColumnFlags_PreferSortDescending);
-        ImGui::TableSetupColumn("Memory Usage (%)", ImGuiTableColumnFlags_PreferSortDescending);
+        ImGui::TableSetupScrollFreeze(0, 1);
+        ImGui::TableSetupColumn("PID", ImGuiTableColumnFlags_DefaultSort, -1.0f, static_cast<ImU32>(ProcessColumn::Pid));
+        ImGui::TableSetupColumn("Name", 0, -1.0f, static_cast<ImU32>(ProcessColumn::Name));
+        ImGui::TableSetupColumn("State", 0, -1.0f, static_cast<ImU32>(ProcessColumn::State));
+        ImGui::TableSetupColumn("CPU Usage (%)", ImGuiTableColumnFlags_PreferSortDescending, -1.0f,
+                                static_cast<ImU32>(ProcessColumn::Cpu));
+        ImGui::TableSetupColumn("Memory Usage (%)", ImGuiTableColumnFlags_PreferSortDescending, -1.0f,
+                                static_cast<ImU32>(ProcessColumn::Memory));
+        ImGui::TableSetupColumn("RSS", ImGuiTableColumnFlags_PreferSortDescending, -1.0f,
+                                static_cast<ImU32>(ProcessColumn::Rss));
+        if (showMemoryDetail) {
+            ImGui::TableSetupColumn("Anon", ImGuiTableColumnFlags_PreferSortDescending, -1.0f,
+                                    static_cast<ImU32>(ProcessColumn::RssAnon));
+            ImGui::TableSetupColumn("File", ImGuiTableColumnFlags_PreferSortDescending, -1.0f,
+                                    static_cast<ImU32>(ProcessColumn::RssFile));
+            ImGui::TableSetupColumn("Shmem", ImGuiTableColumnFlags_PreferSortDescending, -1.0f,
+                                    static_cast<ImU32>(ProcessColumn::RssShmem));
+            ImGui::TableSetupColumn("Swap", ImGuiTableColumnFlags_PreferSortDescending, -1.0f,
+                                    static_cast<ImU32>(ProcessColumn::Swap));
+        }
+        ImGui::TableSetupColumn("Threads", ImGuiTableColumnFlags_PreferSortDescending, -1.0f,
+                                static_cast<ImU32>(ProcessColumn::Threads));
+        if (showPss) {
+            ImGui::TableSetupColumn("PSS", ImGuiTableColumnFlags_PreferSortDescending, -1.0f,
+                                    static_cast<ImU32>(ProcessColumn::Pss));
+            ImGui::TableSetupColumn("USS", ImGuiTableColumnFlags_PreferSortDescending, -1.0f,
+                                    static_cast<ImU32>(ProcessColumn::Uss));
+            ImGui::TableSetupColumn("PSS Age", ImGuiTableColumnFlags_NoSort);
+        }
+        if (showIo) {
+            ImGui::TableSetupColumn("Disk Read", ImGuiTableColumnFlags_PreferSortDescending, -1.0f,
+                                    static_cast<ImU32>(ProcessColumn::IoRead));
+            ImGui::TableSetupColumn("Disk Write", ImGuiTableColumnFlags_PreferSortDescending, -1.0f,
+                                    static_cast<ImU32>(ProcessColumn::IoWrite));
+            ImGui::TableSetupColumn("I/O Syscalls/s", ImGuiTableColumnFlags_PreferSortDescending, -1.0f,
+                                    static_cast<ImU32>(ProcessColumn::IoSyscalls));
+        }
+        if (treeMode) {
+            ImGui::TableSetupColumn("Subtree CPU (%)");
+            ImGui::TableSetupColumn("Subtree Memory (%)");
+        }
         ImGui::TableHeadersRow();
 
-        // Display processes
-        for (const auto& process : displayProcessList) {
-            if (process.name.empty() || process.state.empty() || process.cpuUsage <= -1) {
-                continue;
+        // Follow the header's sort column; the permutation is only rebuilt when it or the snapshot changes
+        if (!treeMode) {
+            if (ImGuiTableSortSpecs* sortSpecs = ImGui::TableGetSortSpecs()) {
+                if (sortSpecs->SpecsDirty && sortSpecs->SpecsCount > 0) {
+                    view.sortSpec.column = static_cast<ProcessColumn>(sortSpecs->Specs[0].ColumnUserID);
+                    view.sortSpec.descending = sortSpecs->Specs[0].SortDirection == ImGuiSortDirection_Descending;
+                }
+                sortSpecs->SpecsDirty = false;
             }
-            if (strlen(filterText) > 0 && process.name.find(filterText) == std::string::npos) {
-                continue;
+            if (view.order.update(view.snapshot, view.sortSpec)) {
+                view.visibleDirty = true;
             }
+        }
+        if (view.filter.update(filterText, view.snapshot)) {
+            view.visibleDirty = true;
+        }
+        if (view.visibleDirty) {
+            if (treeMode) {
+                UpdateVisibleTreeRows(view);
+            } else {
+                UpdateVisibleRows(view);
+            }
+        }
 
-            ImGui::TableNextRow();
-            ImGui::PushID(process.pid);
+        // Display processes
+        const ProcessTable& table = view.snapshot->table;
+        const std::vector<int>& pids = table.pids();
+        const std::vector<unsigned long long>& startTimes = table.startTimes();
+        const std::vector<ProcState>& states = table.states();
+        const std::vector<float>& cpu = table.cpu();
+        const std::vector<float>& mem = table.mem();
 
-            bool isSelected = selectedPIDs.find(process.pid) != selectedPIDs.end();
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
 
-            if (isSelected) {
-                ImGui::TableSetBgColor(ImGuiTableBgTarget_RowBg1, IM_COL32(0, 128, 0, 100));
-            }
+        ImGuiListClipper clipper;
+        clipper.Begin(static_cast<int>(view.visibleRows.size()));
+        while (clipper.Step()) {
+            for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+                uint32_t row = view.visibleRows[i];
+
+                ImGui::TableNextRow();
+                ImGui::PushID(pids[row]);
+
+                std::pair<int, unsigned long long> identity(pids[row], startTimes[row]);
+                bool isSelected = view.selected.count(identity) > 0;
 
-            // Display process information
-            ImGui::TableSetColumnIndex(0);
-            if (ImGui::Selectable(std::to_string(process.pid).c_str(), isSelected, 
-                                ImGuiSelectableFlags_SpanAllColumns | ImGuiSelectableFlags_AllowItemOverlap)) {
                 if (isSelected) {
-                    selectedPIDs.erase(process.pid);
+                    ImGui::TableSetBgColor(ImGuiTableBgTarget_RowBg1, IM_COL32(0, 128, 0, 100));
+                }
+
+                // Display process information
+                char pidLabel[16];
+                snprintf(pidLabel, sizeof(pidLabel), "%d", pids[row]);
+                ImGui::TableSetColumnIndex(0);
+                if (ImGui::Selectable(pidLabel, isSelected, 
+                                    ImGuiSelectableFlags_SpanAllColumns | ImGuiSelectableFlags_AllowItemOverlap)) {
+                    if (isSelected) {
+                        view.selected.erase(identity);
+                    } else {
+                        view.selected.insert(identity);
+                    }
+                    PrioritizeSelectedPss(view);
+                }
+
+                // Tree rows listed only as ancestors of matches, or already exited, are dimmed
+                bool context = treeMode && (!view.filter.matches(row) ||
+                                            (!view.exited.empty() && view.exited.count(identity) > 0));
+                if (context) {
+                    ImGui::PushStyleColor(ImGuiCol_Text, ImGui::GetStyleColorVec4(ImGuiCol_TextDisabled));
+                }
+
+                ImGui::TableSetColumnIndex(1);
+                if (treeMode) {
+                    RenderTreeNameCell(view, row, identity);
                 } else {
-                    selectedPIDs.insert(process.pid);
+                    ImGui::TextUnformatted(table.name(row).c_str());
+                    if (ImGui::IsItemHovered() && !table.cmdline(row).empty()) {
+                        ImGui::SetTooltip("%s", table.cmdline(row).c_str());
+                    }
+                }
+                ImGui::TableSetColumnIndex(2);
+                ImGui::TextUnformatted(ProcStateLabel(states[row]));
+                ImGui::TableSetColumnIndex(3);
+                ImGui::Text("%.2f", cpu[row]);
+                ImGui::TableSetColumnIndex(4);
+                ImGui::Text("%.2f", mem[row]);
+                int column = 5;
+                ImGui::TableSetColumnIndex(column++);
+                ImGui::TextUnformatted(FormatSizeKb(table.rss()[row]).c_str());
+                if (showMemoryDetail) {
+                    // Negative sizes come from samples that only read statm
+                    ImGui::TableSetColumnIndex(column++);
+                    ImGui::TextUnformatted(FormatSizeKb(table.rssAnon()[row]).c_str());
+                    ImGui::TableSetColumnIndex(column++);
+                    ImGui::TextUnformatted(FormatSizeKb(table.rssFile()[row]).c_str());
+                    ImGui::TableSetColumnIndex(column++);
+                    ImGui::TextUnformatted(FormatSizeKb(table.rssShmem()[row]).c_str());
+                    ImGui::TableSetColumnIndex(column++);
+                    ImGui::TextUnformatted(FormatSizeKb(table.swap()[row]).c_str());
+                }
+                ImGui::TableSetColumnIndex(column++);
+                ImGui::Text("%ld", table.threads()[row]);
+                if (showPss) {
+                    // Values come from the pass that last read the process, so their age is shown
+                    ImGui::TableSetColumnIndex(column++);
+                    ImGui::TextUnformatted(FormatSizeKb(table.pss()[row]).c_str());
+                    ImGui::TableSetColumnIndex(column++);
+                    ImGui::TextUnformatted(FormatSizeKb(table.uss()[row]).c_str());
+                    ImGui::TableSetColumnIndex(column++);
+                    std::chrono::steady_clock::time_point sampledAt = table.pssSampledAt()[row];
+                    if (sampledAt == std::chrono::steady_clock::time_point{}) {
+                        ImGui::TextDisabled("not yet");
+                    } else {
+                        ImGui::Text("%.0f s", std::chrono::duration<double>(now - sampledAt).count());
+                    }
+                }
+                if (showIo) {
+                    // Negative rates mean the process's io file may not be read
+                    ImGui::TableSetColumnIndex(column++);
+                    ImGui::TextUnformatted(FormatRate(table.ioRead()[row]).c_str());
+                    ImGui::TableSetColumnIndex(column++);
+                    ImGui::TextUnformatted(FormatRate(table.ioWrite()[row]).c_str());
+                    ImGui::TableSetColumnIndex(column++);
+                    if (table.ioSyscalls()[row] < 0) {
+                        ImGui::TextUnformatted("n/a");
+                    } else {
+                        ImGui::Text("%.0f", table.ioSyscalls()[row]);
+                    }
+                }
+                if (treeMode) {
+                    const ProcessTreeLayout& tree = view.snapshot->tree;
+                    ImGui::TableSetColumnIndex(column++);
+                    ImGui::Text("%.2f", tree.subtreeCpu[row]);
+                    ImGui::TableSetColumnIndex(column++);
+                    ImGui::Text("%.2f", tree.subtreeMem[row]);
+                }
+
+                if (context) {
+                    ImGui::PopStyleColor();
                 }
+
+                ImGui::PopID();
             }
+        }
 
-            ImGui::TableSetColumnIndex(1);
-            ImGui::TextUnformatted(process.name.c_str());
-            ImGui::TableSetColumnIndex(2);
-            ImGui::TextUnformatted(process.state.c_str());
-            ImGui::TableSetColumnIndex(3);
-            ImGui::Text("%.2f", process.cpuUsage);
-            ImGui::TableSetColumnIndex(4);
-            ImGui::Text("%.2f", process.memoryUsage);
+        ImGui::EndTable();
+    }
+    ImGui::PopStyleVar();
+}
 
-            ImGui::PopID();
+// Renders the cgroup hierarchy as a foldable tree; only rows scrolled into view are submitted
+static void RenderCgroupTree() {
+    static std::shared_ptr<const CgroupSnapshot> snapshot;
+    static std::set<std::string> collapsed;   // Paths of folded cgroups
+    static std::vector<uint32_t> visibleNodes;
+    static bool visibleDirty = true;
+
+    std::shared_ptr<const CgroupSnapshot> latest = LatestCgroupSnapshot();
+    if (latest && latest != snapshot) {
+        snapshot = std::move(latest);
+        visibleDirty = true;
+    }
+    if (!snapshot) {
+        ImGui::TextDisabled("Reading cgroups...");
+        return;
+    }
+    if (snapshot->mountPoint.empty()) {
+        ImGui::TextDisabled("No cgroup v2 hierarchy is mounted");
+        return;
+    }
+    ImGui::Text("%zu cgroups under %s (%llu syscalls per pass)", snapshot->nodes.size(),
+                snapshot->mountPoint.c_str(), snapshot->syscalls);
+
+    // Nodes are in pre-order, so a folded cgroup skips its whole subtree in one step
+    const std::vector<CgroupInfo>& nodes = snapshot->nodes;
+    if (visibleDirty) {
+        visibleNodes.clear();
+        for (size_t i = 0; i < nodes.size();) {
+            visibleNodes.push_back(static_cast<uint32_t>(i));
+            bool folded = nodes[i].subtreeSize > 1 && !collapsed.empty() && collapsed.count(nodes[i].path) > 0;
+            i += folded ? nodes[i].subtreeSize : 1;
         }
+        visibleDirty = false;
+    }
+
+    ImGui::PushStyleVar(ImGuiStyleVar_CellPadding, ImVec2(10, 5));
+    if (ImGui::BeginTable("CgroupTree", 7, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders |
+                          ImGuiTableFlags_Resizable | ImGuiTableFlags_ScrollY, ImGui::GetContentRegionAvail())) {
+        ImGui::TableSetupScrollFreeze(0, 1);
+        ImGui::TableSetupColumn("Cgroup");
+        ImGui::TableSetupColumn("CPU (%)");
+        ImGui::TableSetupColumn("Memory");
+        ImGui::TableSetupColumn("Throttled");
+        ImGui::TableSetupColumn("Read");
+        ImGui::TableSetupColumn("Write");
+        ImGui::TableSetupColumn("CPU pressure");
+        ImGui::TableHeadersRow();
+
+        ImGuiListClipper clipper;
+        clipper.Begin(static_cast<int>(visibleNodes.size()));
+        while (clipper.Step()) {
+            for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+                const CgroupInfo& node = nodes[visibleNodes[i]];
+                ImGui::TableNextRow();
+                ImGui::PushID(node.path.c_str());
+
+                // Name, indented by depth, with an arrow that folds the subtree
+                ImGui::TableSetColumnIndex(0);
+                float indent = node.depth * ImGui::GetStyle().IndentSpacing * 0.5f;
+                if (indent > 0.0f) {
+                    ImGui::Indent(indent);
+                }
+                ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_NoTreePushOnOpen | ImGuiTreeNodeFlags_SpanFullWidth;
+                bool hasChildren = node.subtreeSize > 1;
+                bool folded = hasChildren && collapsed.count(node.path) > 0;
+                if (hasChildren) {
+                    ImGui::SetNextItemOpen(!folded);
+                } else {
+                    flags |= ImGuiTreeNodeFlags_Leaf;
+                }
+                bool open = ImGui::TreeNodeEx("##cgroup", flags, "%s", node.name.c_str());
+                if (ImGui::IsItemHovered()) {
+                    ImGui::SetTooltip("%s", node.path.c_str());
+                }
+                if (hasChildren && open == folded) {
+                    if (folded) {
+                        collapsed.erase(node.path);
+                    } else {
+                        collapsed.insert(node.path);
+                    }
+                    visibleDirty = true;
+                }
+                if (indent > 0.0f) {
+                    ImGui::Unindent(indent);
+                }
+
+                ImGui::TableSetColumnIndex(1);
+                if (node.cpuUsage < 0) {
+                    ImGui::TextDisabled("n/a");
+                } else {
+                    ImGui::Text("%.2f", node.cpuUsage);
+                }
+                ImGui::TableSetColumnIndex(2);
+                if (node.memoryBytes < 0) {
+                    ImGui::TextDisabled("n/a");
+                } else {
+                    ImGui::TextUnformatted(formatBytes(node.memoryBytes).c_str());
+                }
+                ImGui::TableSetColumnIndex(3);
+                if (node.throttledPercent < 0) {
+                    ImGui::TextDisabled("n/a");
+                } else {
+                    // Share of periods throttled, and how long per second
+                    ImGui::Text("%.1f%% (%.0f ms/s)", node.throttledPercent, node.throttledMsPerSec);
+                }
+                ImGui::TableSetColumnIndex(4);
+                ImGui::TextUnformatted(FormatRate(node.readBytesPerSec).c_str());
+                ImGui::TableSetColumnIndex(5);
+                ImGui::TextUnformatted(FormatRate(node.writeBytesPerSec).c_str());
+                ImGui::TableSetColumnIndex(6);
+                if (node.cpuPressureSome < 0) {
+                    ImGui::TextDisabled("n/a");
+                } else if (node.cpuPressureFull < 0) {
+                    ImGui::Text("%.2f%%", node.cpuPressureSome);
+                } else {
+                    ImGui::Text("%.2f%% / %.2f%%", node.cpuPressureSome, node.cpuPressureFull);
+                }
 
+                ImGui::PopID();
+            }
+        }
         ImGui::EndTable();
     }
     ImGui::PopStyleVar();
+}
+
+// Renders the cost of the displayed scan and the controls that pace the collector
+static void RenderScanPacing(const ProcessTableView& view) {
+    static int slices = g_scanSlices;
+    static int budgetMs = g_sliceCpuBudgetUs / 1000;
+    static int pssBudgetMs = g_pssBudgetUs / 1000;
+
+    if (!ImGui::CollapsingHeader("Scan pacing")) {
+        return;
+    }
+
+    ImGui::SetNextItemWidth(200);
+    if (ImGui::SliderInt("Slices per interval", &slices, 1, PROC_SCAN_MAX_SLICES)) {
+        g_scanSlices = slices;
+    }
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(200);
+    if (ImGui::SliderInt("CPU budget per slice", &budgetMs, 0, 100, budgetMs == 0 ? "unlimited" : "%d ms")) {
+        g_sliceCpuBudgetUs = budgetMs * 1000;
+    }
+
+    const ScanPassStats& pass = view.snapshot->pass;
+    double cpuMs = std::chrono::duration<double, std::milli>(pass.cpuTime).count();
+    double maxSliceCpuMs = std::chrono::duration<double, std::milli>(pass.maxSliceCpuTime).count();
+    double wallMs = std::chrono::duration<double, std::milli>(pass.wallTime).count();
+    ImGui::Text("Last pass: %zu reads in %u of %u slices, %.1f ms CPU (%.1f ms in the busiest slice), %.0f ms",
+                pass.sampled, pass.slicesRun, pass.plannedSlices, cpuMs, maxSliceCpuMs, wallMs);
+    if (pass.deferred > 0) {
+        ImGui::Text("The CPU budget pushed reads to a later slice %zu times", pass.deferred);
+    }
+
+    // smaps_rollup is read after the slices, for as many processes as its own budget allows
+    if (g_collectPss) {
+        ImGui::SetNextItemWidth(200);
+        if (ImGui::SliderInt("PSS budget per pass", &pssBudgetMs, 1, 200, "%d ms")) {
+            g_pssBudgetUs = pssBudgetMs * 1000;
+        }
+        ImGui::SameLine();
+        ImGui::Text("Last pass read smaps_rollup of %zu processes in %.1f ms", pass.pssRead,
+                    std::chrono::duration<double, std::milli>(pass.pssTime).count());
+    }
+}
+
+// Renders the K processes using the most CPU or memory in the displayed scan,
+// in a pane beside the process table
+static void RenderTopConsumers(const ProcessTableView& view) {
+    static int metricIndex = 0; // 0 = CPU, 1 = Memory
+    static int topCount = 20;
+    static TopConsumers topConsumers;
+
+    const char* metrics[] = {"CPU", "Memory"};
+    ImGui::SetNextItemWidth(120);
+    ImGui::Combo("Metric", &metricIndex, metrics, IM_ARRAYSIZE(metrics));
+    ImGui::SetNextItemWidth(-FLT_MIN);
+    ImGui::SliderInt("##Count", &topCount, 1, 100, "Top %d");
+
+    ProcessColumn metric = metricIndex == 1 ? ProcessColumn::Memory : ProcessColumn::Cpu;
+    topConsumers.update(view.snapshot, metric, static_cast<size_t>(topCount), view.exited);
+
+    const ProcessTable& table = view.snapshot->table;
+    const std::vector<float>& values = metric == ProcessColumn::Memory ? table.mem() : table.cpu();
+    if (ImGui::BeginTable("TopConsumers", 4, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders)) {
+        ImGui::TableSetupColumn("#");
+        ImGui::TableSetupColumn("PID");
+        ImGui::TableSetupColumn("Name");
+        ImGui::TableSetupColumn(metric == ProcessColumn::Memory ? "Memory Usage (%)" : "CPU Usage (%)");
+        ImGui::TableHeadersRow();
+
+        int rank = 0;
+        for (uint32_t row : topConsumers.rows()) {
+            ImGui::TableNextRow();
+            ImGui::TableSetColumnIndex(0);
+            ImGui::Text("%d", ++rank);
+            ImGui::TableSetColumnIndex(1);
+            ImGui::Text("%d", table.pids()[row]);
+            ImGui::TableSetColumnIndex(2);
+            ImGui::TextUnformatted(table.name(row).c_str());
+            ImGui::TableSetColumnIndex(3);
+            ImGui::Text("%.2f", values[row]);
+        }
+        ImGui::EndTable();
+    }
+}
+
+// Renders process monitor UI with filtering and sorting
+void RenderProcessMonitorUI() {
+    ImGui::PushFont(ImGui::GetIO().Fonts->Fonts[1]);
+    
+    static char filterText[256] = "";
+    static ProcessTableView view;
+    static bool fetchThreadStarted = false;
+
+    // Start process fetching thread once
+    if (!fetchThreadStarted) {
+        fetchThreadStarted = true;
+        std::thread([]() {
+            StartFetchingProcesses();
+        }).detach();
+    }
+
+    // Pick up the latest scan; the collector replaces it as a whole, never in place
+    std::shared_ptr<const ProcessSnapshot> latest = LatestProcessSnapshot();
+    if (latest) {
+        ShowProcessSnapshot(view, std::move(latest));
+    }
+
+    ProcessInfo exited;
+    while (g_exitedProcesses.try_pop(exited)) {
+        HideExitedProcess(view, exited.pid);
+    }
+
+    size_t listedProcesses = view.snapshot ? view.snapshot->table.size() : 0;
+    ImGui::Text("Total Number of Processes: %zu", listedProcesses - view.exited.size());
+    size_t quarantined = g_deadlineReader.quarantinedCount();
+    if (quarantined > 0) {
+        // PIDs whose cmdline/status reads blocked; shown with their stat name and rss
+        ImGui::SameLine();
+        ImGui::TextColored(ImVec4(1.0f, 0.6f, 0.0f, 1.0f), "(%zu unresponsive)", quarantined);
+    }
+    if (view.snapshot && view.snapshot->pass.overran) {
+        // The collector could not read every due process within one interval
+        ImGui::SameLine();
+        ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "(scan overran its %.0f s interval, %llu times so far)",
+                           std::chrono::duration<double>(PROC_SCAN_INTERVAL).count(),
+                           view.snapshot->pass.overruns);
+    }
+    ImGui::InputTextWithHint("##Filter", "Filter: text ^prefix /regex/ state:R cpu>5 mem<1 pid=1", filterText,
+                             IM_ARRAYSIZE(filterText));
+    if (!view.filter.error().empty()) {
+        ImGui::SameLine();
+        ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "%s", view.filter.error().c_str());
+    }
+    ImGui::SameLine();
+    if (ImGui::Checkbox("Tree view", &view.treeMode)) {
+        view.visibleDirty = true;
+    }
+    static bool showCgroups = false;
+    ImGui::SameLine();
+    ImGui::Checkbox("Cgroups", &showCgroups);
+    static bool showTopConsumers = true;
+    ImGui::SameLine();
+    ImGui::Checkbox("Top consumers", &showTopConsumers);
+
+    // Collector backend toggle
+    static bool useIoUring = false;
+    if (ImGui::Checkbox("Batch /proc reads (io_uring)", &useIoUring)) {
+        g_useIoUring = useIoUring;
+    }
+    if (useIoUring && !g_ioUringActive) {
+        ImGui::SameLine();
+        ImGui::TextDisabled("(unavailable, using direct reads)");
+    }
+    static bool collectIo = false;
+    ImGui::SameLine();
+    if (ImGui::Checkbox("Disk I/O columns", &collectIo)) {
+        g_collectIo = collectIo;
+    }
+    static bool collectMemoryDetail = false;
+    ImGui::SameLine();
+    if (ImGui::Checkbox("Memory breakdown columns", &collectMemoryDetail)) {
+        g_collectMemoryDetail = collectMemoryDetail;
+    }
+    static bool collectPss = false;
+    ImGui::SameLine();
+    if (ImGui::Checkbox("PSS/USS columns", &collectPss)) {
+        g_collectPss = collectPss;
+    }
+
+    if (listedProcesses == 0) {
+        ImGui::Text("No processes found.");
+        ImGui::PopFont();
+        return;
+    }
+
+    RenderScanPacing(view);
+
+    // The top consumers and the cgroup tree sit to the right of the process table
+    // when shown, so they never push the table down
+    if (showTopConsumers || showCgroups) {
+        float spacing = ImGui::GetStyle().ItemSpacing.x;
+        float width = ImGui::GetContentRegionAvail().x;
+        float topWidth = showTopConsumers ? width * 0.25f + spacing : 0.0f;
+        float cgroupWidth = showCgroups ? width * (showTopConsumers ? 0.35f : 0.45f) + spacing : 0.0f;
+        ImGui::BeginChild("ProcessPane", ImVec2(-topWidth - cgroupWidth, 0));
+        RenderProcessTable(view, filterText);
+        ImGui::EndChild();
+        if (showTopConsumers) {
+            ImGui::SameLine();
+            ImGui::BeginChild("TopConsumersPane", ImVec2(showCgroups ? topWidth - spacing : 0.0f, 0));
+            RenderTopConsumers(view);
+            ImGui::EndChild();
+        }
+        if (showCgroups) {
+            ImGui::SameLine();
+            ImGui::BeginChild("CgroupPane", ImVec2(0, 0));
+            RenderCgroupTree();
+            ImGui::EndChild();
+        }
+    } else {
+        RenderProcessTable(view, filterText);
+    }
 
     ImGui::PopFont();
 }
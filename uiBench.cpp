@@ -0,0 +1,135 @@
+#include "header.h"
+
+// Frame-time benchmark of the process table: renders synthetic snapshots of
+// increasing size headlessly (no window or GPU) and reports the CPU time
+// ImGui spends per frame building the table, then the memory a row takes in
+// the columnar table against a vector of ProcessInfo.
+//
+// Usage: ./uibench [frames]
+
+namespace {
+
+/**
+ * Builds one synthetic process
+ *
+ * @param i Index of the process
+ * @return Process with varied name, state and usage values
+ */
+ProcessInfo MakeProcess(size_t i) {
+    ProcessInfo process{};
+    process.pid = static_cast<int>(i + 1);
+    process.startTime = i;
+    process.name = "process-" + std::to_string(i % 500);
+    process.state = i % 7 == 0 ? ProcState::Running : ProcState::Sleeping;
+    process.cpuUsage = static_cast<float>(i % 1000) / 10.0f;
+    process.memoryUsage = static_cast<float>(i % 300) / 30.0f;
+    process.isActive = true;
+    return process;
+}
+
+/**
+ * Builds a synthetic snapshot with the given number of processes
+ *
+ * @param rows Number of processes
+ * @return Snapshot with varied names, states and usage values
+ */
+std::shared_ptr<const ProcessSnapshot> MakeSnapshot(size_t rows) {
+    auto names = std::make_shared<NameInterner>();
+    auto snapshot = std::make_shared<ProcessSnapshot>(
+        ProcessSnapshot{1, std::chrono::steady_clock::now(), ProcessTable(names), ScanPassStats{}, ProcessTreeLayout{}, {}});
+    snapshot->table.reserve(rows);
+    for (size_t i = 0; i < rows; i++) {
+        ProcessInfo process = MakeProcess(i);
+        snapshot->table.append(process, names->intern(process.name));
+    }
+    return snapshot;
+}
+
+/**
+ * Measures the bytes per process of the columnar table and of the
+ * vector of ProcessInfo the UI kept before it
+ *
+ * @param rows Number of processes
+ * @param tableBytes Output, table bytes per row
+ * @param structBytes Output, ProcessInfo bytes per row, heap-allocated names included
+ */
+void MeasureRowBytes(size_t rows, double& tableBytes, double& structBytes) {
+    tableBytes = static_cast<double>(MakeSnapshot(rows)->table.memoryBytes()) / rows;
+
+    std::vector<ProcessInfo> processes;
+    processes.reserve(rows);
+    size_t bytes = processes.capacity() * sizeof(ProcessInfo);
+    for (size_t i = 0; i < rows; i++) {
+        processes.push_back(MakeProcess(i));
+        const std::string& name = processes.back().name;
+        if (name.capacity() > std::string().capacity()) {
+            bytes += name.capacity() + 1; // Longer than the inline buffer
+        }
+    }
+    structBytes = static_cast<double>(bytes) / rows;
+}
+
+/**
+ * Renders the process table for a number of frames
+ *
+ * @param rows Number of processes in the snapshot
+ * @param frames Number of timed frames
+ * @return Average microseconds per frame
+ */
+double TimeFrames(size_t rows, int frames) {
+    ProcessTableView view;
+    view.snapshot = MakeSnapshot(rows);
+
+    auto renderFrame = [&view]() {
+        ImGui::NewFrame();
+        ImGui::SetNextWindowPos(ImVec2(0, 0));
+        ImGui::SetNextWindowSize(ImVec2(1280, 720));
+        ImGui::Begin("Processes");
+        RenderProcessTable(view, "");
+        ImGui::End();
+        ImGui::Render();
+    };
+
+    // Untimed frames sort the rows and let the clipper measure row height
+    for (int i = 0; i < 5; i++) {
+        renderFrame();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; i++) {
+        renderFrame();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::micro>(elapsed).count() / frames;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    int frames = argc > 1 ? std::max(1, atoi(argv[1])) : 200;
+
+    ImGui::CreateContext();
+    ImGuiIO& io = ImGui::GetIO();
+    io.IniFilename = nullptr;
+    io.DisplaySize = ImVec2(1280, 720);
+    io.DeltaTime = 1.0f / 60.0f;
+    unsigned char* pixels;
+    int width, height;
+    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+
+    printf("%10s %14s\n", "rows", "us/frame");
+    for (size_t rows : {100, 1000, 10000, 100000}) {
+        printf("%10zu %14.1f\n", rows, TimeFrames(rows, frames));
+    }
+
+    printf("\n%10s %14s %14s\n", "rows", "table B/row", "struct B/row");
+    for (size_t rows : {1000, 100000}) {
+        double tableBytes = 0;
+        double structBytes = 0;
+        MeasureRowBytes(rows, tableBytes, structBytes);
+        printf("%10zu %14.1f %14.1f\n", rows, tableBytes, structBytes);
+    }
+
+    ImGui::DestroyContext();
+    return 0;
+}